@@ -1,9 +1,40 @@
 
 
+#include "Telemetry.h"
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
 #ifndef CUSTOM_ALLOCATOR
 #define CUSTOM_ALLOCATOR
 
-template<class _Alloc>
+namespace Marigold {
+
+	//Marigold allocators declare is_byte_sized and take sizes in bytes, standard ones (std::allocator,
+	//std::pmr::polymorphic_allocator) take element counts. Containers work out the bytes they need and pass them
+	//through allocation_size, so both kinds can be used.
+	template<class A>
+	concept IsByteSized = requires { typename A::is_byte_sized; } && A::is_byte_sized::value;
+
+	template<class A>
+	constexpr inline std::size_t allocation_size(const std::size_t bytes) noexcept {
+		if constexpr (IsByteSized<A>)
+			return bytes;
+		else {
+			constexpr std::size_t ElementSize = sizeof(typename std::allocator_traits<A>::value_type);
+			return (bytes + ElementSize - 1) / ElementSize;
+		}
+	}
+}
+
+//Alignment of 0 keeps the natural alignment of the type, anything larger is honored with an aligned heap allocation.
+//Every event is reported to the Telemetry policy, see Telemetry.h.
+template<class _Alloc, std::size_t Alignment = 0, class Telemetry = Marigold::DefaultTelemetry>
 class CustomAllocator final {
 public:
 	using value_type = _Alloc;
@@ -15,35 +46,42 @@ public:
 	using propagate_on_container_move_assignment = std::true_type;
 	using propagate_on_container_copy_assignment = std::true_type;
 	using propagate_on_container_swap			 = std::true_type;
+	using is_byte_sized							 = std::true_type; //allocate/deallocate take bytes, not elements.
 	//using is_always_equal						 = std::true_type; //C++17 for non-empty allocators that are always equal
 
-public:
-	struct AllocatorLog {
-		size_type m_Allocations = 0;
-		size_type m_Deallocations = 0;
-		size_type m_AllocatedMemory = 0;
-		size_type m_DeallocatedMemory = 0;
-		size_type m_Constructions = 0;
-		size_type m_Deconstructions = 0;
+	template<class U>
+	struct rebind {
+		using other = CustomAllocator<U, Alignment, Telemetry>;
 	};
 
+	static constexpr size_type ALIGNMENT = Alignment > alignof(_Alloc) ? Alignment : alignof(_Alloc);
+	static constexpr bool OVER_ALIGNED = ALIGNMENT > alignof(std::max_align_t);
+
+	static_assert((ALIGNMENT & (ALIGNMENT - 1)) == 0, "Alignment has to be a power of two.");
+	static_assert(Marigold::IsTelemetryPolicy<Telemetry>, "Telemetry has to provide the hooks of Marigold::NoTelemetry.");
+
+public:
+	using AllocatorLog = Marigold::TelemetrySnapshot;
+
 public:
 	CustomAllocator() noexcept {}
 	~CustomAllocator() {}
 
 	template <class U>
-	inline CustomAllocator(const CustomAllocator<U>&) noexcept {}
+	inline CustomAllocator(const CustomAllocator<U, Alignment, Telemetry>&) noexcept {}
 
 public:
 	template<class T, class... args>
 	constexpr inline void construct(T* address, args&&... arguments) {
 		std::construct_at(address, std::forward<args>(arguments)...);
-		m_Log.m_Constructions++;
+		if (!std::is_constant_evaluated())
+			Telemetry::on_construct();
 	}
 	template<class T>
 	constexpr inline void destroy(T* address) {
 		std::destroy_at(address);
-		m_Log.m_Deconstructions++;
+		if (!std::is_constant_evaluated())
+			Telemetry::on_destroy();
 	}
 
 public:
@@ -51,9 +89,11 @@ public:
 		if (size == 0)
 			return nullptr;
 
-		m_Log.m_AllocatedMemory += size;
-		m_Log.m_Allocations++;
-		return static_cast<pointer>(malloc(size));;
+		Telemetry::on_allocate(size);
+		if constexpr (OVER_ALIGNED)
+			return static_cast<pointer>(aligned_allocate(size));
+		else
+			return static_cast<pointer>(malloc(size));
 	}
 
 	template<typename T>
@@ -61,33 +101,75 @@ public:
 		if (!address)
 			return;
 
-		m_Log.m_DeallocatedMemory += size;
-		m_Log.m_Deallocations++;
-		free(address);
+		Telemetry::on_deallocate(size);
+		if constexpr (OVER_ALIGNED)
+			aligned_free(address);
+		else
+			free(address);
+	}
+
+	[[nodiscard]] inline pointer reallocate(pointer address, const size_type oldSize, const size_type newSize) {
+		//Only valid for trivially relocatable types, realloc may move the block with a plain copy.
+		pointer Block = nullptr;
+		if constexpr (OVER_ALIGNED) {
+#if defined(_MSC_VER)
+			Block = static_cast<pointer>(_aligned_realloc(address, newSize, ALIGNMENT));
+#else
+			//No aligned realloc outside of MSVC, the copy is still a single memcpy.
+			Block = static_cast<pointer>(aligned_allocate(newSize));
+			if (Block) {
+				std::memcpy(Block, address, oldSize < newSize ? oldSize : newSize);
+				aligned_free(address);
+			}
+#endif
+		}
+		else
+			Block = static_cast<pointer>(realloc(address, newSize));
+
+		//Reported once the move happened, the new block first so the peak includes both while they coexist.
+		if (Block) {
+			Telemetry::on_allocate(newSize);
+			Telemetry::on_deallocate(oldSize);
+		}
+		return Block;
 	}
 
 public:
 	constexpr inline size_type max_size() const noexcept {
 		return std::numeric_limits<size_type>::max() / sizeof(value_type);
 	}
-	constexpr inline AllocatorLog log() const noexcept {
-		return m_Log; 
+	inline AllocatorLog log() const noexcept {
+		//Counters are shared by every allocator with the same Telemetry policy.
+		return Telemetry::snapshot();
 	}
 
 private:
-	AllocatorLog m_Log;
+	static inline void* aligned_allocate(const size_type size) noexcept {
+#if defined(_MSC_VER)
+		return _aligned_malloc(size, ALIGNMENT);
+#else
+		//aligned_alloc requires the size to be a multiple of the alignment.
+		return std::aligned_alloc(ALIGNMENT, (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+#endif
+	}
+	static inline void aligned_free(void* address) noexcept {
+#if defined(_MSC_VER)
+		_aligned_free(address);
+#else
+		free(address);
+#endif
+	}
 };
 
-namespace {
-	template <class T, class U>
-	constexpr bool operator==(const CustomAllocator<T>&, const CustomAllocator<U>&) noexcept {
-		return true; //true
-	}
+//Declared at global scope next to CustomAllocator so argument dependent lookup finds them from inside other namespaces.
+template <class T, class U, std::size_t Alignment, class Telemetry>
+constexpr bool operator==(const CustomAllocator<T, Alignment, Telemetry>&, const CustomAllocator<U, Alignment, Telemetry>&) noexcept {
+	return true; //true
+}
 
-	template <class T, class U>
-	constexpr bool operator!=(const CustomAllocator<T>&, const CustomAllocator<U>&) noexcept {
-		return false; //false
-	}
+template <class T, class U, std::size_t Alignment, class Telemetry>
+constexpr bool operator!=(const CustomAllocator<T, Alignment, Telemetry>&, const CustomAllocator<U, Alignment, Telemetry>&) noexcept {
+	return false; //false
 }
 #endif // !CUSTOM_ALLOCATOR
 
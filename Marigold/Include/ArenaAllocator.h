@@ -0,0 +1,266 @@
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+
+#ifndef ARENA_ALLOCATOR_H
+#define ARENA_ALLOCATOR_H
+
+
+namespace Marigold {
+
+	inline constexpr std::size_t DEFAULT_ARENA_SLAB_SIZE = 64 * 1024;
+
+	//Bump allocator over a chain of slabs. Deallocation is a no-op unless the block is the last one handed out,
+	//memory is returned all at once through reset() (keeps slabs for reuse) or release() (returns slabs upstream).
+	//An optional seed buffer, typically on the stack, is used as the first slab and never returned upstream.
+	class MonotonicArena final {
+	public:
+		using size_type = std::size_t;
+		using Byte = unsigned char;
+
+	private:
+		struct Slab {
+			Slab* m_Next = nullptr;
+			size_type m_Capacity = 0;
+
+			inline Byte* begin() noexcept { return reinterpret_cast<Byte*>(this) + HEADER_SIZE; }
+			inline Byte* end() noexcept { return begin() + m_Capacity; }
+		};
+
+		static constexpr size_type HEADER_SIZE = (sizeof(Slab) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+	public:
+		explicit MonotonicArena(size_type slabSize = DEFAULT_ARENA_SLAB_SIZE, MonotonicArena* upstream = nullptr) noexcept
+			: m_NextSlabSize(slabSize == 0 ? DEFAULT_ARENA_SLAB_SIZE : slabSize), m_Upstream(upstream)
+		{
+		}
+		MonotonicArena(void* seed, const size_type seedSize, size_type slabSize = DEFAULT_ARENA_SLAB_SIZE, MonotonicArena* upstream = nullptr) noexcept
+			: MonotonicArena(slabSize, upstream)
+		{
+			//The slab header goes at the front of the seed, a seed too small to hold it is ignored.
+			Byte* Start = align(static_cast<Byte*>(seed), alignof(std::max_align_t));
+			const size_type Padding = static_cast<size_type>(Start - static_cast<Byte*>(seed));
+			if (!seed || seedSize < Padding + HEADER_SIZE + alignof(std::max_align_t))
+				return;
+
+			m_Seed = ::new (Start) Slab;
+			m_Seed->m_Capacity = seedSize - Padding - HEADER_SIZE;
+			m_Reserved = m_Seed->m_Capacity;
+			m_Head = m_Seed;
+			reset();
+		}
+		~MonotonicArena() {
+			release();
+		}
+
+		MonotonicArena(const MonotonicArena&) = delete;
+		MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+	public:
+		[[nodiscard]] inline void* allocate(const size_type size, const size_type alignment = alignof(std::max_align_t)) {
+			if (size == 0)
+				return nullptr;
+
+			Byte* Address = align(m_Cursor, alignment);
+			if (!m_Cursor || Address + size > m_End) {
+				next_slab(size + alignment);
+				Address = align(m_Cursor, alignment);
+			}
+
+			m_Cursor = Address + size;
+			m_Used += size;
+			return Address;
+		}
+		inline void deallocate(void* address, const size_type size) noexcept {
+			//Only the most recent block can be given back, everything else waits for reset/release.
+			if (!address || static_cast<Byte*>(address) + size != m_Cursor)
+				return;
+
+			m_Cursor = static_cast<Byte*>(address);
+			m_Used -= size;
+		}
+		inline bool try_expand(void* address, const size_type oldSize, const size_type newSize) noexcept {
+			//Grows the most recent block in place when the current slab still has room for it.
+			if (!address || static_cast<Byte*>(address) + oldSize != m_Cursor)
+				return false;
+			if (newSize < oldSize || static_cast<Byte*>(address) + newSize > m_End)
+				return false;
+
+			m_Cursor = static_cast<Byte*>(address) + newSize;
+			m_Used += newSize - oldSize;
+			return true;
+		}
+
+		inline void reset() noexcept {
+			//Rewinds to the first slab, every slab is kept and reused by subsequent allocations.
+			m_Current = m_Head;
+			m_Cursor = m_Head ? m_Head->begin() : nullptr;
+			m_End = m_Head ? m_Head->end() : nullptr;
+			m_Used = 0;
+		}
+		inline void release() noexcept {
+			//The seed belongs to the caller, it stays as the only slab.
+			Slab* Iterator = m_Head;
+			while (Iterator) {
+				Slab* Next = Iterator->m_Next;
+				if (Iterator != m_Seed)
+					deallocate_slab(Iterator);
+				Iterator = Next;
+			}
+
+			m_Head = m_Seed;
+			m_Reserved = 0;
+			if (m_Seed) {
+				m_Seed->m_Next = nullptr;
+				m_Reserved = m_Seed->m_Capacity;
+			}
+			reset();
+		}
+
+	public:
+		constexpr inline MonotonicArena* upstream() const noexcept { return m_Upstream; }
+		constexpr inline size_type used() const noexcept { return m_Used; }
+		constexpr inline size_type reserved() const noexcept { return m_Reserved; }
+
+	private:
+		static inline Byte* align(Byte* address, const size_type alignment) noexcept {
+			const std::uintptr_t Value = reinterpret_cast<std::uintptr_t>(address);
+			return reinterpret_cast<Byte*>((Value + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1));
+		}
+
+		inline void next_slab(const size_type minimum) {
+			//Reuse slabs kept by reset() before asking upstream for more memory.
+			while (m_Current && m_Current->m_Next) {
+				m_Current = m_Current->m_Next;
+				if (m_Current->m_Capacity >= minimum) {
+					m_Cursor = m_Current->begin();
+					m_End = m_Current->end();
+					return;
+				}
+			}
+
+			size_type Capacity = m_NextSlabSize;
+			while (Capacity < minimum)
+				Capacity *= 2;
+			m_NextSlabSize = Capacity * 2;
+
+			Slab* NewSlab = allocate_slab(Capacity);
+			if (m_Current) {
+				NewSlab->m_Next = m_Current->m_Next;
+				m_Current->m_Next = NewSlab;
+			}
+			else
+				m_Head = NewSlab;
+
+			m_Current = NewSlab;
+			m_Cursor = NewSlab->begin();
+			m_End = NewSlab->end();
+		}
+
+		inline Slab* allocate_slab(const size_type capacity) {
+			void* Block = nullptr;
+			if (m_Upstream)
+				Block = m_Upstream->allocate(HEADER_SIZE + capacity);
+			else
+				Block = malloc(HEADER_SIZE + capacity);
+
+			if (!Block)
+				throw std::bad_alloc();
+
+			m_Reserved += capacity;
+			Slab* NewSlab = ::new (Block) Slab;
+			NewSlab->m_Capacity = capacity;
+			return NewSlab;
+		}
+		inline void deallocate_slab(Slab* slab) noexcept {
+			if (m_Upstream)
+				m_Upstream->deallocate(slab, HEADER_SIZE + slab->m_Capacity);
+			else
+				free(slab);
+		}
+
+	private:
+		Slab* m_Head = nullptr;
+		Slab* m_Current = nullptr;
+		Slab* m_Seed = nullptr;
+		Byte* m_Cursor = nullptr;
+		Byte* m_End = nullptr;
+		size_type m_NextSlabSize = DEFAULT_ARENA_SLAB_SIZE;
+		size_type m_Used = 0;
+		size_type m_Reserved = 0;
+		MonotonicArena* m_Upstream = nullptr;
+	};
+
+
+	//Allocator handle for Container<T, ArenaAllocator<T>>, all copies share the arena they were built with.
+	template<class _Alloc>
+	class ArenaAllocator final {
+	public:
+		using value_type = _Alloc;
+		using pointer = _Alloc*;
+		using size_type = std::size_t;
+		using const_pointer = const _Alloc*;
+		using const_reference = const _Alloc&;
+
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_copy_assignment = std::false_type;
+		using propagate_on_container_swap			 = std::true_type;
+		using is_byte_sized							 = std::true_type;
+
+	public:
+		constexpr ArenaAllocator(MonotonicArena& arena) noexcept
+			: m_Arena(&arena)
+		{
+		}
+
+		template <class U>
+		constexpr ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+			: m_Arena(other.arena())
+		{
+		}
+
+	public:
+		[[nodiscard]] inline pointer allocate(const size_type size) {
+			if (size == 0)
+				return nullptr;
+
+			return static_cast<pointer>(m_Arena->allocate(size, alignof(value_type)));
+		}
+
+		template<typename T>
+		inline void deallocate(T* address, size_type size) noexcept {
+			m_Arena->deallocate(address, size);
+		}
+
+		inline bool try_expand(pointer address, const size_type oldSize, const size_type newSize) noexcept {
+			return m_Arena->try_expand(address, oldSize, newSize);
+		}
+
+	public:
+		constexpr inline size_type max_size() const noexcept {
+			return std::numeric_limits<size_type>::max() / sizeof(value_type);
+		}
+		constexpr inline MonotonicArena* arena() const noexcept {
+			return m_Arena;
+		}
+
+	private:
+		MonotonicArena* m_Arena = nullptr;
+	};
+
+	template <class T, class U>
+	constexpr bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+		return lhs.arena() == rhs.arena();
+	}
+
+	template <class T, class U>
+	constexpr bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+		return lhs.arena() != rhs.arena();
+	}
+}
+
+#endif // !ARENA_ALLOCATOR_H
@@ -0,0 +1,411 @@
+#include "Container.h"
+#include <cstddef>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+#ifndef BIT_CONTAINER_H
+#define BIT_CONTAINER_H
+
+
+namespace Marigold {
+
+	//Sequence of flags packed 64 to a word in a Container of words. Counting, searching and combining work a word at
+	//a time, the bitwise loops are plain enough for the compiler to vectorize. Bits past size() in the last word are
+	//always zero, so whole words can be counted and compared. Elements are reached through a Reference proxy.
+	//Searches return size() when nothing is found.
+	template<class Alloc = CustomAllocator<std::uint64_t>>
+	class BitContainer final {
+	public:
+		using Type = bool;
+		using Word = std::uint64_t;
+		using Allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Word>;
+		using Storage = Container<Word, Allocator>;
+		using SizeType = std::size_t;
+		using DifferenceType = std::ptrdiff_t;
+		using InitializerList = std::initializer_list<bool>;
+
+		static constexpr SizeType WORD_BITS = std::numeric_limits<Word>::digits;
+
+		//Stands in for bool& to a single bit.
+		class Reference {
+		public:
+			Reference(Word* word, const Word mask) noexcept
+				: m_Word(word), m_Mask(mask)
+			{
+			}
+			Reference(const Reference&) noexcept = default;
+
+			inline operator bool() const noexcept { return (*m_Word & m_Mask) != 0; }
+			inline Reference& operator=(const bool value) noexcept {
+				if (value)
+					*m_Word |= m_Mask;
+				else
+					*m_Word &= ~m_Mask;
+				return *this;
+			}
+			inline Reference& operator=(const Reference& other) noexcept { return *this = static_cast<bool>(other); }
+			inline void flip() noexcept { *m_Word ^= m_Mask; }
+
+		private:
+			Word* m_Word;
+			Word m_Mask;
+		};
+
+	private:
+		//Reads bits by index, so elements are returned by value.
+		class BasicIterator {
+		public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::input_iterator_tag; //Elements are returned by value.
+			using value_type = bool;
+			using difference_type = DifferenceType;
+			using reference = bool;
+
+		public:
+			BasicIterator() noexcept = default;
+			BasicIterator(const Word* words, const SizeType index) noexcept
+				: m_Words(words), m_Index(index)
+			{
+			}
+
+			inline reference operator*() const noexcept { return (m_Words[m_Index / WORD_BITS] >> (m_Index % WORD_BITS)) & 1; }
+			inline reference operator[](const difference_type offset) const noexcept { return *(*this + offset); }
+
+			inline BasicIterator& operator++() noexcept { ++m_Index; return *this; }
+			inline BasicIterator operator++(int) noexcept { BasicIterator Previous = *this; ++*this; return Previous; }
+			inline BasicIterator& operator--() noexcept { --m_Index; return *this; }
+			inline BasicIterator operator--(int) noexcept { BasicIterator Previous = *this; --*this; return Previous; }
+
+			inline BasicIterator& operator+=(const difference_type offset) noexcept { m_Index += offset; return *this; }
+			inline BasicIterator& operator-=(const difference_type offset) noexcept { m_Index -= offset; return *this; }
+
+			friend inline BasicIterator operator+(BasicIterator iterator, const difference_type offset) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator+(const difference_type offset, BasicIterator iterator) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator-(BasicIterator iterator, const difference_type offset) noexcept { return iterator -= offset; }
+			friend inline difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+				return static_cast<difference_type>(lhs.m_Index) - static_cast<difference_type>(rhs.m_Index);
+			}
+
+			inline bool operator==(const BasicIterator& other) const noexcept { return m_Index == other.m_Index; }
+			inline auto operator<=>(const BasicIterator& other) const noexcept { return m_Index <=> other.m_Index; }
+
+		private:
+			const Word* m_Words = nullptr;
+			SizeType m_Index = 0;
+		};
+
+	public:
+		using Iterator = BasicIterator;
+		using ConstantIterator = BasicIterator;
+		using ReverseIterator = std::reverse_iterator<Iterator>;
+		using ReverseConstantIterator = ReverseIterator;
+
+	public: //Special member functions
+		BitContainer() = default;
+		explicit BitContainer(const Allocator& allocator)
+			: m_Words(allocator)
+		{
+		}
+		BitContainer(const SizeType count, const bool value, const Allocator& allocator = Allocator())
+			: m_Words(allocator)
+		{
+			resize(count, value);
+		}
+		explicit BitContainer(const SizeType count, const Allocator& allocator = Allocator())
+			: BitContainer(count, false, allocator)
+		{
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		BitContainer(InputIterator first, Sentinel last, const Allocator& allocator = Allocator())
+			: m_Words(allocator)
+		{
+			for (; first != last; ++first)
+				push_back(static_cast<bool>(*first));
+		}
+		BitContainer(InitializerList list, const Allocator& allocator = Allocator())
+			: BitContainer(list.begin(), list.end(), allocator)
+		{
+		}
+
+		BitContainer(const BitContainer&) = default;
+		BitContainer& operator=(const BitContainer&) = default;
+		BitContainer(BitContainer&& other) noexcept
+			: m_Words(std::move(other.m_Words)), m_Size(std::exchange(other.m_Size, 0))
+		{
+		}
+		BitContainer& operator=(BitContainer&& other) noexcept {
+			if (this == &other)
+				return *this;
+
+			m_Words = std::move(other.m_Words);
+			m_Size = std::exchange(other.m_Size, 0);
+			return *this;
+		}
+
+	public: //Access
+		inline bool at(SizeType index) const {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return test(index);
+		}
+		inline Reference at(SizeType index) {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return (*this)[index];
+		}
+
+		inline Reference operator[](SizeType index) noexcept {
+			assert(index < size() && "Index out of range");
+			return Reference(m_Words.data() + index / WORD_BITS, Word(1) << (index % WORD_BITS));
+		}
+		inline bool operator[](SizeType index) const noexcept { return test(index); }
+		inline bool test(SizeType index) const noexcept {
+			assert(index < size() && "Index out of range");
+			return (m_Words[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+		}
+
+		inline Reference front() noexcept { return (*this)[0]; }
+		inline bool front() const noexcept { return test(0); }
+		inline Reference back() noexcept { return (*this)[m_Size - 1]; }
+		inline bool back() const noexcept { return test(m_Size - 1); }
+
+		inline const Word* data() const noexcept { return m_Words.data(); }
+		inline const Storage& words() const noexcept { return m_Words; }
+		inline SizeType word_count() const noexcept { return m_Words.size(); }
+
+	public: //Bit operations
+		inline void set(SizeType index, const bool value = true) noexcept { (*this)[index] = value; }
+		inline void reset(SizeType index) noexcept { set(index, false); }
+		inline void flip(SizeType index) noexcept { (*this)[index].flip(); }
+
+		inline void set() noexcept {
+			std::fill(m_Words.begin(), m_Words.end(), ~Word(0));
+			clear_tail();
+		}
+		inline void reset() noexcept { std::fill(m_Words.begin(), m_Words.end(), Word(0)); }
+		inline void flip() noexcept {
+			for (Word& Bits : m_Words)
+				Bits = ~Bits;
+			clear_tail();
+		}
+
+		//Sets or clears count bits starting at first, whole words in between are filled directly.
+		void set_range(const SizeType first, const SizeType count, const bool value = true) noexcept {
+			assert(first <= size() && count <= size() - first && "Range out of range");
+			if (count == 0)
+				return;
+
+			const SizeType Last = first + count;
+			const SizeType FirstWord = first / WORD_BITS;
+			const SizeType LastWord = (Last - 1) / WORD_BITS;
+			const Word Head = ~Word(0) << (first % WORD_BITS);
+			const Word Tail = ~Word(0) >> (WORD_BITS - 1 - (Last - 1) % WORD_BITS);
+			Word* Words = m_Words.data();
+
+			if (FirstWord == LastWord) {
+				apply(Words[FirstWord], Head & Tail, value);
+				return;
+			}
+
+			apply(Words[FirstWord], Head, value);
+			std::fill(Words + FirstWord + 1, Words + LastWord, value ? ~Word(0) : Word(0));
+			apply(Words[LastWord], Tail, value);
+		}
+		inline void reset_range(const SizeType first, const SizeType count) noexcept { set_range(first, count, false); }
+
+		inline SizeType count() const noexcept {
+			SizeType Total = 0;
+			for (const Word Bits : m_Words)
+				Total += static_cast<SizeType>(std::popcount(Bits));
+			return Total;
+		}
+		inline bool any() const noexcept { return std::any_of(m_Words.begin(), m_Words.end(), [](const Word bits) { return bits != 0; }); }
+		inline bool none() const noexcept { return !any(); }
+		inline bool all() const noexcept { return count() == m_Size; }
+
+		inline SizeType find_first() const noexcept { return find_next(0); }
+		//First set bit at or after index.
+		SizeType find_next(const SizeType index) const noexcept {
+			if (index >= m_Size)
+				return m_Size;
+
+			SizeType Current = index / WORD_BITS;
+			Word Bits = m_Words[Current] & (~Word(0) << (index % WORD_BITS));
+			while (Bits == 0) {
+				if (++Current == m_Words.size())
+					return m_Size;
+				Bits = m_Words[Current];
+			}
+
+			return Current * WORD_BITS + static_cast<SizeType>(std::countr_zero(Bits));
+		}
+		inline SizeType find_first_unset() const noexcept { return find_next_unset(0); }
+		//First clear bit at or after index.
+		SizeType find_next_unset(const SizeType index) const noexcept {
+			if (index >= m_Size)
+				return m_Size;
+
+			SizeType Current = index / WORD_BITS;
+			Word Bits = ~m_Words[Current] & (~Word(0) << (index % WORD_BITS));
+			while (Bits == 0) {
+				if (++Current == m_Words.size())
+					return m_Size;
+				Bits = ~m_Words[Current];
+			}
+
+			const SizeType Found = Current * WORD_BITS + static_cast<SizeType>(std::countr_zero(Bits));
+			return Found < m_Size ? Found : m_Size;
+		}
+
+		//Calls function(index) for every set bit in order, skipping clear words whole.
+		template<class Function>
+		void for_each_set(Function function) const {
+			for (SizeType Current = 0; Current < m_Words.size(); Current++) {
+				for (Word Bits = m_Words[Current]; Bits != 0; Bits &= Bits - 1)
+					function(Current * WORD_BITS + static_cast<SizeType>(std::countr_zero(Bits)));
+			}
+		}
+
+		//Both operands have to hold the same number of bits.
+		inline BitContainer& operator&=(const BitContainer& other) {
+			combine(other, [](const Word lhs, const Word rhs) { return lhs & rhs; });
+			return *this;
+		}
+		inline BitContainer& operator|=(const BitContainer& other) {
+			combine(other, [](const Word lhs, const Word rhs) { return lhs | rhs; });
+			return *this;
+		}
+		inline BitContainer& operator^=(const BitContainer& other) {
+			combine(other, [](const Word lhs, const Word rhs) { return lhs ^ rhs; });
+			return *this;
+		}
+		//Clears the bits set in other.
+		inline BitContainer& subtract(const BitContainer& other) {
+			combine(other, [](const Word lhs, const Word rhs) { return lhs & ~rhs; });
+			return *this;
+		}
+		inline BitContainer operator~() const {
+			BitContainer Result(*this);
+			Result.flip();
+			return Result;
+		}
+
+	public: //Insertion
+		inline void push_back(const bool value) {
+			if (m_Size % WORD_BITS == 0)
+				m_Words.push_back(Word(0));
+
+			m_Words.back() |= Word(value) << (m_Size % WORD_BITS);
+			m_Size++;
+		}
+
+	public: //Removal
+		inline void pop_back() noexcept {
+			if (m_Size == 0)
+				return;
+
+			resize(m_Size - 1);
+		}
+		inline void clear() noexcept {
+			m_Words.clear();
+			m_Size = 0;
+		}
+
+	public: //Iterators
+		inline ConstantIterator begin() const noexcept { return ConstantIterator(m_Words.data(), 0); }
+		inline ConstantIterator cbegin() const noexcept { return begin(); }
+		inline ConstantIterator end() const noexcept { return ConstantIterator(m_Words.data(), m_Size); }
+		inline ConstantIterator cend() const noexcept { return end(); }
+
+		inline ReverseConstantIterator rbegin() const noexcept { return ReverseConstantIterator(end()); }
+		inline ReverseConstantIterator crbegin() const noexcept { return rbegin(); }
+		inline ReverseConstantIterator rend() const noexcept { return ReverseConstantIterator(begin()); }
+		inline ReverseConstantIterator crend() const noexcept { return rend(); }
+
+	public: //Capacity
+		inline void reserve(SizeType capacity) { m_Words.reserve(words_for(capacity)); }
+		inline void shrink_to_fit() { m_Words.shrink_to_fit(); }
+		inline void swap(BitContainer& other) noexcept {
+			m_Words.swap(other.m_Words);
+			std::swap(m_Size, other.m_Size);
+		}
+
+		void resize(SizeType count, const bool value = false) {
+			const SizeType Old = m_Size;
+			m_Words.resize(words_for(count), Word(0));
+			m_Size = count;
+			if (count > Old && value)
+				set_range(Old, count - Old);
+			else
+				clear_tail();
+		}
+
+		inline SizeType size() const noexcept { return m_Size; }
+		inline bool empty() const noexcept { return m_Size == 0; }
+		inline SizeType capacity() const noexcept { return m_Words.capacity() * WORD_BITS; }
+		inline SizeType max_size() const noexcept { return m_Words.max_size() < std::numeric_limits<SizeType>::max() / WORD_BITS ? m_Words.max_size() * WORD_BITS : std::numeric_limits<SizeType>::max(); }
+		inline Allocator get_allocator() const noexcept { return m_Words.get_allocator(); }
+
+	private:
+		static constexpr inline SizeType words_for(const SizeType bits) noexcept { return (bits + WORD_BITS - 1) / WORD_BITS; }
+		static inline void apply(Word& word, const Word mask, const bool value) noexcept {
+			word = value ? word | mask : word & ~mask;
+		}
+
+		inline void clear_tail() noexcept {
+			if (m_Size % WORD_BITS)
+				m_Words.back() &= ~Word(0) >> (WORD_BITS - m_Size % WORD_BITS);
+		}
+
+		template<class Operation>
+		inline void combine(const BitContainer& other, Operation operation) {
+			if (other.m_Size != m_Size)
+				throw std::invalid_argument("Bit containers differ in size");
+
+			Word* Words = m_Words.data();
+			const Word* Others = other.m_Words.data();
+			for (SizeType i = 0; i < m_Words.size(); i++)
+				Words[i] = operation(Words[i], Others[i]);
+		}
+
+	private:
+		Storage m_Words;
+		SizeType m_Size = 0;
+	};
+
+
+	//Non-member functions
+	template<class Allocator>
+	inline void swap(BitContainer<Allocator>& lhs, BitContainer<Allocator>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+
+	//Operators
+	template<class Allocator>
+	inline BitContainer<Allocator> operator&(BitContainer<Allocator> lhs, const BitContainer<Allocator>& rhs) { return lhs &= rhs; }
+	template<class Allocator>
+	inline BitContainer<Allocator> operator|(BitContainer<Allocator> lhs, const BitContainer<Allocator>& rhs) { return lhs |= rhs; }
+	template<class Allocator>
+	inline BitContainer<Allocator> operator^(BitContainer<Allocator> lhs, const BitContainer<Allocator>& rhs) { return lhs ^= rhs; }
+
+	template<class Allocator>
+	bool operator==(const BitContainer<Allocator>& lhs, const BitContainer<Allocator>& rhs) {
+		return lhs.size() == rhs.size() && lhs.words() == rhs.words();
+	}
+}
+
+#endif // !BIT_CONTAINER_H
@@ -0,0 +1,418 @@
+#include "Container.h"
+#include "Simd.h"
+#include <cstddef>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+#ifndef COMPRESSED_CONTAINER_H
+#define COMPRESSED_CONTAINER_H
+
+
+namespace Marigold {
+
+	template<class T>
+	concept IsCompressible = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+	//Encodings turn a block of values into unsigned residuals, the container packs them with the fewest bits that
+	//hold the largest one. Arithmetic is done on the unsigned type U and wraps, so signed values need no special case.
+
+	//Stores every value as its distance from the block minimum. Any element decodes on its own.
+	struct FrameOfReferenceEncoding {
+		template<class T, class U>
+		static inline void encode(const T* values, U* residuals, U& reference, U& step) noexcept {
+			reference = static_cast<U>(*std::min_element(values, values + Simd::PACKED_BLOCK));
+			step = 0;
+			for (std::size_t i = 0; i < Simd::PACKED_BLOCK; i++)
+				residuals[i] = static_cast<U>(static_cast<U>(values[i]) - reference);
+		}
+
+		template<class T, class U>
+		static inline void decode(const std::uint32_t* residuals, const U reference, const U, T* values) noexcept {
+			for (std::size_t i = 0; i < Simd::PACKED_BLOCK; i++)
+				values[i] = static_cast<T>(static_cast<U>(reference + residuals[i]));
+		}
+
+		template<class U, class Read>
+		static inline U decode_one(const std::size_t index, const U reference, const U, Read read) {
+			return static_cast<U>(reference + read(index));
+		}
+	};
+
+	//Stores the difference to the previous value less the smallest difference in the block, so sorted IDs and
+	//evenly spaced timestamps pack into a few bits or none. Reading one element sums the residuals before it.
+	struct DeltaEncoding {
+		template<class T, class U>
+		static inline void encode(const T* values, U* residuals, U& reference, U& step) noexcept {
+			reference = static_cast<U>(values[0]);
+			step = std::numeric_limits<U>::max();
+			for (std::size_t i = 1; i < Simd::PACKED_BLOCK; i++) {
+				residuals[i] = static_cast<U>(static_cast<U>(values[i]) - static_cast<U>(values[i - 1]));
+				step = residuals[i] < step ? residuals[i] : step;
+			}
+
+			residuals[0] = 0;
+			for (std::size_t i = 1; i < Simd::PACKED_BLOCK; i++)
+				residuals[i] = static_cast<U>(residuals[i] - step);
+		}
+
+		template<class T, class U>
+		static inline void decode(const std::uint32_t* residuals, const U reference, const U step, T* values) noexcept {
+			U Value = reference;
+			values[0] = static_cast<T>(Value);
+			for (std::size_t i = 1; i < Simd::PACKED_BLOCK; i++) {
+				Value = static_cast<U>(Value + residuals[i] + step);
+				values[i] = static_cast<T>(Value);
+			}
+		}
+
+		template<class U, class Read>
+		static inline U decode_one(const std::size_t index, const U reference, const U step, Read read) {
+			U Value = reference;
+			for (std::size_t i = 1; i <= index; i++)
+				Value = static_cast<U>(Value + read(i) + step);
+			return Value;
+		}
+	};
+
+
+	//Append only sequence of integers stored as bit packed blocks of BLOCK_SIZE values. Each block has a header with
+	//its encoding parameters, bit width and word offset, so element i is found with one division and decoded from
+	//its block alone. Values still filling the last block are kept plain until the block is full.
+	//Blocks whose residuals need more than 32 bits are stored unpacked. Elements are returned by value.
+	template<
+		IsCompressible T,
+		class Encoding = FrameOfReferenceEncoding,
+		class Alloc = CustomAllocator<T>
+	>
+	class CompressedContainer final {
+	public:
+		using Type = T;
+		using Allocator = Alloc;
+		using SizeType = std::size_t;
+		using DifferenceType = std::ptrdiff_t;
+		using InitializerList = std::initializer_list<Type>;
+
+		static constexpr SizeType BLOCK_SIZE = Simd::PACKED_BLOCK;
+
+	private:
+		using Unsigned = std::make_unsigned_t<T>;
+
+		static constexpr unsigned char RAW_WIDTH = std::numeric_limits<unsigned char>::max();
+		static constexpr SizeType RAW_WORDS = BLOCK_SIZE * sizeof(T) / sizeof(std::uint32_t);
+
+		struct BlockHeader {
+			Unsigned m_Reference;
+			Unsigned m_Step;
+			SizeType m_Offset;
+			unsigned char m_Width;
+		};
+
+		using AllocatorTraits = std::allocator_traits<Alloc>;
+		using Headers = Container<BlockHeader, typename AllocatorTraits::template rebind_alloc<BlockHeader>>;
+		using Words = Container<std::uint32_t, typename AllocatorTraits::template rebind_alloc<std::uint32_t>>;
+		using Tail = Container<T, Alloc>;
+
+		//Reads elements through operator[], so it is cheap to copy. Scans should prefer for_each, which decodes whole blocks.
+		class BasicIterator {
+		public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::input_iterator_tag; //Elements are returned by value.
+			using value_type = Type;
+			using difference_type = DifferenceType;
+			using reference = Type;
+
+		public:
+			BasicIterator() noexcept = default;
+			BasicIterator(const CompressedContainer* owner, const SizeType index) noexcept
+				: m_Owner(owner), m_Index(index)
+			{
+			}
+
+			inline reference operator*() const { return (*m_Owner)[m_Index]; }
+			inline reference operator[](const difference_type offset) const { return *(*this + offset); }
+
+			inline BasicIterator& operator++() noexcept { ++m_Index; return *this; }
+			inline BasicIterator operator++(int) noexcept { BasicIterator Previous = *this; ++*this; return Previous; }
+			inline BasicIterator& operator--() noexcept { --m_Index; return *this; }
+			inline BasicIterator operator--(int) noexcept { BasicIterator Previous = *this; --*this; return Previous; }
+
+			inline BasicIterator& operator+=(const difference_type offset) noexcept { m_Index += offset; return *this; }
+			inline BasicIterator& operator-=(const difference_type offset) noexcept { m_Index -= offset; return *this; }
+
+			friend inline BasicIterator operator+(BasicIterator iterator, const difference_type offset) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator+(const difference_type offset, BasicIterator iterator) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator-(BasicIterator iterator, const difference_type offset) noexcept { return iterator -= offset; }
+			friend inline difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+				return static_cast<difference_type>(lhs.m_Index) - static_cast<difference_type>(rhs.m_Index);
+			}
+
+			inline bool operator==(const BasicIterator& other) const noexcept { return m_Index == other.m_Index; }
+			inline auto operator<=>(const BasicIterator& other) const noexcept { return m_Index <=> other.m_Index; }
+
+		private:
+			const CompressedContainer* m_Owner = nullptr;
+			SizeType m_Index = 0;
+		};
+
+	public:
+		using Iterator = BasicIterator;
+		using ConstantIterator = BasicIterator;
+		using ReverseIterator = std::reverse_iterator<Iterator>;
+		using ReverseConstantIterator = ReverseIterator;
+
+	public: //Special member functions
+		CompressedContainer() = default;
+		explicit CompressedContainer(const Alloc& allocator)
+			: m_Headers(typename Headers::Allocator(allocator)), m_Words(typename Words::Allocator(allocator)), m_Tail(allocator)
+		{
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		CompressedContainer(InputIterator first, Sentinel last, const Alloc& allocator = Alloc())
+			: CompressedContainer(allocator)
+		{
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+		template<std::ranges::input_range Range>
+		CompressedContainer(FromRangeTag, Range&& range, const Alloc& allocator = Alloc())
+			: CompressedContainer(allocator)
+		{
+			append_range(std::forward<Range>(range));
+		}
+		CompressedContainer(InitializerList list, const Alloc& allocator = Alloc())
+			: CompressedContainer(list.begin(), list.end(), allocator)
+		{
+		}
+
+	public: //Access
+		inline Type at(SizeType index) const {
+			if (index >= size())
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return (*this)[index];
+		}
+		inline Type operator[](SizeType index) const {
+			assert(index < size() && "Index out of range");
+			const SizeType Block = index / BLOCK_SIZE;
+			if (Block == m_Headers.size())
+				return m_Tail[index % BLOCK_SIZE];
+
+			const BlockHeader& Header = m_Headers[Block];
+			const std::uint32_t* Data = m_Words.data() + Header.m_Offset;
+			if (Header.m_Width == RAW_WIDTH) {
+				T Value;
+				std::memcpy(&Value, Data + (index % BLOCK_SIZE) * (sizeof(T) / sizeof(std::uint32_t)), sizeof(T));
+				return Value;
+			}
+
+			const auto Read = [Data, Width = Header.m_Width](const SizeType i) { return Simd::unpack_one(Data, Width, i); };
+			return static_cast<T>(Encoding::decode_one(index % BLOCK_SIZE, Header.m_Reference, Header.m_Step, Read));
+		}
+
+		inline Type front() const { return (*this)[0]; }
+		inline Type back() const { return (*this)[size() - 1]; }
+
+		//Decodes the BLOCK_SIZE values of block into out, the last partial block is copied as is.
+		void decode_block(const SizeType block, Type* out) const {
+			assert(block < block_count() && "Block out of range");
+			if (block == m_Headers.size()) {
+				std::copy(m_Tail.begin(), m_Tail.end(), out);
+				return;
+			}
+
+			const BlockHeader& Header = m_Headers[block];
+			const std::uint32_t* Data = m_Words.data() + Header.m_Offset;
+			if (Header.m_Width == RAW_WIDTH) {
+				std::memcpy(out, Data, BLOCK_SIZE * sizeof(T));
+				return;
+			}
+
+			alignas(16) std::uint32_t Residuals[BLOCK_SIZE];
+			Simd::unpack(Data, Header.m_Width, Residuals);
+			Encoding::decode(Residuals, Header.m_Reference, Header.m_Step, out);
+		}
+
+		//Calls function(values, count) once per block with the block decoded into a local buffer, in order.
+		//The fastest way to scan, each block is unpacked with the widest kernel available.
+		template<class Function>
+		void for_each_block(Function function) const {
+			alignas(64) T Values[BLOCK_SIZE];
+			for (SizeType Block = 0; Block < m_Headers.size(); Block++) {
+				decode_block(Block, Values);
+				function(static_cast<const T*>(Values), BLOCK_SIZE);
+			}
+			if (!m_Tail.empty())
+				function(m_Tail.data(), m_Tail.size());
+		}
+		template<class Function>
+		inline void for_each(Function function) const {
+			for_each_block([&function](const T* values, const SizeType count) {
+				for (SizeType i = 0; i < count; i++)
+					function(values[i]);
+			});
+		}
+
+		//Decodes every element into out, which has to hold size() of them.
+		inline void copy_to(Type* out) const {
+			for_each_block([&out](const T* values, const SizeType count) {
+				out = std::copy(values, values + count, out);
+			});
+		}
+		template<class OtherAlloc = Alloc>
+		Container<Type, OtherAlloc> decompress(const OtherAlloc& allocator = OtherAlloc()) const {
+			Container<Type, OtherAlloc> Result(allocator);
+			Result.resize_for_overwrite(size());
+			copy_to(Result.data());
+			return Result;
+		}
+
+	public: //Insertion
+		inline void push_back(const Type value) {
+			if (m_Tail.capacity() < BLOCK_SIZE)
+				m_Tail.reserve(BLOCK_SIZE);
+
+			m_Tail.push_back(value);
+			if (m_Tail.size() == BLOCK_SIZE) {
+				//A tail that failed to seal would keep growing past a block, the value is taken back instead.
+				try {
+					seal_tail();
+				}
+				catch (...) {
+					m_Tail.pop_back();
+					throw;
+				}
+			}
+		}
+		template<std::ranges::input_range Range>
+		inline void append_range(Range&& range) {
+			for (auto&& Value : range)
+				push_back(static_cast<Type>(Value));
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		inline void append(InputIterator first, Sentinel last) {
+			for (; first != last; ++first)
+				push_back(static_cast<Type>(*first));
+		}
+		inline void append(InitializerList list) {
+			append(list.begin(), list.end());
+		}
+
+	public: //Removal
+		inline void clear() noexcept {
+			m_Headers.clear();
+			m_Words.clear();
+			m_Tail.clear();
+		}
+
+	public: //Iterators
+		inline ConstantIterator begin() const noexcept { return ConstantIterator(this, 0); }
+		inline ConstantIterator cbegin() const noexcept { return begin(); }
+		inline ConstantIterator end() const noexcept { return ConstantIterator(this, size()); }
+		inline ConstantIterator cend() const noexcept { return end(); }
+
+		inline ReverseConstantIterator rbegin() const noexcept { return ReverseConstantIterator(end()); }
+		inline ReverseConstantIterator crbegin() const noexcept { return rbegin(); }
+		inline ReverseConstantIterator rend() const noexcept { return ReverseConstantIterator(begin()); }
+		inline ReverseConstantIterator crend() const noexcept { return rend(); }
+
+	public: //Capacity
+		inline void shrink_to_fit() {
+			m_Headers.shrink_to_fit();
+			m_Words.shrink_to_fit();
+			m_Tail.shrink_to_fit();
+		}
+		inline void swap(CompressedContainer& other) noexcept {
+			m_Headers.swap(other.m_Headers);
+			m_Words.swap(other.m_Words);
+			m_Tail.swap(other.m_Tail);
+		}
+
+		inline SizeType size() const noexcept { return m_Headers.size() * BLOCK_SIZE + m_Tail.size(); }
+		inline bool empty() const noexcept { return size() == 0; }
+		inline SizeType block_count() const noexcept { return m_Headers.size() + (m_Tail.empty() ? 0 : 1); }
+		//Bytes held by headers, packed words and the open block, the plain equivalent is size() * sizeof(Type).
+		inline SizeType memory_usage() const noexcept {
+			return m_Headers.capacity() * sizeof(BlockHeader) + m_Words.capacity() * sizeof(std::uint32_t) + m_Tail.capacity() * sizeof(T);
+		}
+		inline Allocator get_allocator() const noexcept { return m_Tail.get_allocator(); }
+
+	private:
+		void seal_tail() {
+			//Packs the full tail into a new block, the words are written in place at the end of the stream.
+			alignas(16) Unsigned Residuals[BLOCK_SIZE];
+			BlockHeader Header{};
+			Encoding::encode(m_Tail.data(), Residuals, Header.m_Reference, Header.m_Step);
+			Header.m_Offset = m_Words.size();
+
+			Unsigned Largest = 0;
+			for (SizeType i = 0; i < BLOCK_SIZE; i++)
+				Largest |= Residuals[i];
+			const unsigned Width = static_cast<unsigned>(std::bit_width(Largest));
+
+			m_Headers.reserve(m_Headers.size() + 1);
+			if (Width > 32) {
+				Header.m_Width = RAW_WIDTH;
+				m_Words.resize_for_overwrite(Header.m_Offset + RAW_WORDS);
+				std::memcpy(m_Words.data() + Header.m_Offset, m_Tail.data(), BLOCK_SIZE * sizeof(T));
+			}
+			else {
+				Header.m_Width = static_cast<unsigned char>(Width);
+				alignas(16) std::uint32_t Narrow[BLOCK_SIZE];
+				for (SizeType i = 0; i < BLOCK_SIZE; i++)
+					Narrow[i] = static_cast<std::uint32_t>(Residuals[i]);
+				m_Words.resize_for_overwrite(Header.m_Offset + Simd::packed_words(Width));
+				Simd::pack(Narrow, Width, m_Words.data() + Header.m_Offset);
+			}
+
+			m_Headers.push_back(Header);
+			m_Tail.clear();
+		}
+
+	private:
+		Headers m_Headers;
+		Words m_Words;
+		Tail m_Tail;
+	};
+
+
+	//Non-member functions
+	template<class Type, class Encoding, class Allocator>
+	inline void swap(CompressedContainer<Type, Encoding, Allocator>& lhs, CompressedContainer<Type, Encoding, Allocator>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+
+	//Operators
+	template<class Type, class Encoding, class Allocator>
+	bool operator==(const CompressedContainer<Type, Encoding, Allocator>& lhs, const CompressedContainer<Type, Encoding, Allocator>& rhs) {
+		if (lhs.size() != rhs.size())
+			return false;
+
+		alignas(64) Type Left[Simd::PACKED_BLOCK];
+		alignas(64) Type Right[Simd::PACKED_BLOCK];
+		for (std::size_t Block = 0; Block < lhs.block_count(); Block++) {
+			lhs.decode_block(Block, Left);
+			rhs.decode_block(Block, Right);
+			const std::size_t Count = lhs.size() - Block * Simd::PACKED_BLOCK < Simd::PACKED_BLOCK ? lhs.size() - Block * Simd::PACKED_BLOCK : Simd::PACKED_BLOCK;
+			if (!std::equal(Left, Left + Count, Right))
+				return false;
+		}
+
+		return true;
+	}
+}
+
+#endif // !COMPRESSED_CONTAINER_H
@@ -0,0 +1,326 @@
+#include "Allocator.h"
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+
+#ifndef CONCURRENT_CONTAINER_H
+#define CONCURRENT_CONTAINER_H
+
+
+namespace Marigold {
+
+	//Append only sibling of Container for many producer threads. Storage is a table of segments, segment k holds
+	//FirstSegment << k elements and is never moved, so references stay valid and growth never copies.
+	//push_back and emplace_back are lock-free: a slot is claimed with a compare exchange, a missing segment is installed
+	//with a compare exchange (losers free theirs), and the element is published through its slot state.
+	//Reads of published elements are wait-free. size() is the prefix of published elements, producers advance it
+	//past each other's slots, so everything below size() can be read without further checks.
+	template<
+		class T,
+		class Alloc = CustomAllocator<T>,
+		std::size_t FirstSegment = 64
+	>
+	class ConcurrentContainer final {
+	public:
+		using Type = T;
+		using Allocator = Alloc;
+		using SizeType = std::size_t;
+		using Pointer = Type*;
+		using ConstantPointer = const T*;
+		using Reference = T&;
+		using ConstantReference = const T&;
+		using DifferenceType = std::ptrdiff_t;
+		using AllocatorTraits = std::allocator_traits<Allocator>;
+
+		static_assert(std::is_object_v<T>, "The C++ Standard forbids containers of non-object types "
+			"because of [container.requirements].");
+		static_assert(FirstSegment > 0 && (FirstSegment & (FirstSegment - 1)) == 0, "FirstSegment has to be a power of two.");
+
+		static constexpr SizeType SEGMENT_COUNT = std::numeric_limits<SizeType>::digits - std::countr_zero(FirstSegment);
+
+	private:
+		using SlotState = std::atomic<unsigned char>;
+
+		static constexpr unsigned char SLOT_EMPTY = 0;
+		static constexpr unsigned char SLOT_PUBLISHED = 1;
+		static constexpr unsigned char SLOT_VACANT = 2; //The constructor threw, the slot holds no element.
+
+		template<bool IsConstant>
+		class BasicIterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Type;
+			using difference_type = DifferenceType;
+			using pointer = std::conditional_t<IsConstant, ConstantPointer, Pointer>;
+			using reference = std::conditional_t<IsConstant, ConstantReference, Reference>;
+			using Owner = std::conditional_t<IsConstant, const ConcurrentContainer, ConcurrentContainer>;
+
+		public:
+			BasicIterator() noexcept = default;
+			BasicIterator(Owner* owner, const SizeType index, const SizeType last) noexcept
+				: m_Owner(owner), m_Index(index), m_Last(last)
+			{
+				skip_vacant();
+			}
+
+			inline reference operator*() const noexcept { return (*m_Owner)[m_Index]; }
+			inline pointer operator->() const noexcept { return std::addressof((*m_Owner)[m_Index]); }
+
+			inline BasicIterator& operator++() noexcept {
+				m_Index++;
+				skip_vacant();
+				return *this;
+			}
+			inline BasicIterator operator++(int) noexcept {
+				BasicIterator Previous = *this;
+				++*this;
+				return Previous;
+			}
+
+			inline bool operator==(const BasicIterator& other) const noexcept { return m_Index == other.m_Index; }
+
+		private:
+			inline void skip_vacant() noexcept {
+				while (m_Index < m_Last && !m_Owner->is_published(m_Index))
+					m_Index++;
+			}
+
+		private:
+			Owner* m_Owner = nullptr;
+			SizeType m_Index = 0;
+			SizeType m_Last = 0;
+		};
+
+	public:
+		using Iterator = BasicIterator<false>;
+		using ConstantIterator = BasicIterator<true>;
+
+	public: //Special member functions
+		ConcurrentContainer() noexcept(noexcept(Allocator())) {}
+		explicit ConcurrentContainer(const Allocator& allocator) noexcept
+			: m_Allocator(allocator)
+		{
+		}
+
+		//Slots and segments are shared with running producers, so the container is neither copied nor moved.
+		ConcurrentContainer(const ConcurrentContainer&) = delete;
+		ConcurrentContainer& operator=(const ConcurrentContainer&) = delete;
+
+		~ConcurrentContainer() {
+			clear();
+			for (SizeType Segment = 0; Segment < SEGMENT_COUNT; Segment++) {
+				Pointer Block = m_Segments[Segment].load(std::memory_order_relaxed);
+				if (Block)
+					AllocatorTraits::deallocate(m_Allocator, Block, allocation_size<Allocator>(segment_bytes(Segment)));
+			}
+		}
+
+	public: //Access
+		inline Reference operator[](SizeType index) noexcept {
+			assert(is_published(index) && "Element is not published");
+			return element(index);
+		}
+		inline ConstantReference operator[](SizeType index) const noexcept {
+			assert(is_published(index) && "Element is not published");
+			return element(index);
+		}
+		inline Reference at(SizeType index) {
+			if (!is_published(index))
+				throw std::out_of_range("Access Violation - element is not published");
+
+			return element(index);
+		}
+		inline ConstantReference at(SizeType index) const {
+			if (!is_published(index))
+				throw std::out_of_range("Access Violation - element is not published");
+
+			return element(index);
+		}
+
+		inline bool is_published(SizeType index) const noexcept {
+			//Also true for elements above size() whose producers finished before an earlier one did.
+			if (index >= m_Reserved.load(std::memory_order_acquire))
+				return false;
+
+			const SizeType Segment = segment_of(index);
+			const Pointer Block = m_Segments[Segment].load(std::memory_order_acquire);
+			if (!Block)
+				return false;
+
+			return state(Block, Segment, index - segment_start(Segment)).load(std::memory_order_acquire) == SLOT_PUBLISHED;
+		}
+
+	public: //Insertion
+		inline SizeType push_back(ConstantReference value) {
+			return emplace_index(value);
+		}
+		inline SizeType push_back(Type&& value) {
+			return emplace_index(std::move(value));
+		}
+		template<class... args>
+		inline Reference emplace_back(args&&... arguments) {
+			return element(emplace_index(std::forward<args>(arguments)...));
+		}
+
+	public: //Removal
+		inline void clear() noexcept {
+			//Not thread safe, no producer or reader may be running. Segments are kept for reuse.
+			const SizeType Reserved = m_Reserved.load(std::memory_order_acquire);
+			for (SizeType Segment = 0; Segment < SEGMENT_COUNT && segment_start(Segment) < Reserved; Segment++) {
+				const Pointer Block = m_Segments[Segment].load(std::memory_order_acquire);
+				if (!Block)
+					continue;
+
+				const SizeType Count = Reserved - segment_start(Segment) < segment_size(Segment) ? Reserved - segment_start(Segment) : segment_size(Segment);
+				for (SizeType i = 0; i < Count; i++) {
+					SlotState& Slot = state(Block, Segment, i);
+					if (Slot.load(std::memory_order_relaxed) == SLOT_PUBLISHED)
+						AllocatorTraits::destroy(m_Allocator, Block + i);
+					Slot.store(SLOT_EMPTY, std::memory_order_relaxed);
+				}
+			}
+
+			m_Reserved.store(0, std::memory_order_release);
+			m_Published.store(0, std::memory_order_release);
+		}
+
+	public: //Iterators
+		inline Iterator begin() noexcept { return Iterator(this, 0, size()); }
+		inline ConstantIterator begin() const noexcept { return ConstantIterator(this, 0, size()); }
+		inline ConstantIterator cbegin() const noexcept { return begin(); }
+
+		inline Iterator end() noexcept { const SizeType Size = size(); return Iterator(this, Size, Size); }
+		inline ConstantIterator end() const noexcept { const SizeType Size = size(); return ConstantIterator(this, Size, Size); }
+		inline ConstantIterator cend() const noexcept { return end(); }
+
+	public: //Capacity
+		inline SizeType size() const noexcept { return m_Published.load(std::memory_order_acquire); }
+		inline SizeType reserved_size() const noexcept { return m_Reserved.load(std::memory_order_acquire); }
+		inline bool empty() const noexcept { return size() == 0; }
+		inline SizeType capacity() const noexcept {
+			SizeType Capacity = 0;
+			for (SizeType Segment = 0; Segment < SEGMENT_COUNT; Segment++) {
+				if (m_Segments[Segment].load(std::memory_order_acquire))
+					Capacity = segment_start(Segment) + segment_size(Segment);
+			}
+			return Capacity;
+		}
+		constexpr inline SizeType max_size() const noexcept {
+			const SizeType Limit = std::numeric_limits<SizeType>::max() / (sizeof(Type) + sizeof(SlotState));
+			return Limit < segment_start(SEGMENT_COUNT - 1) ? Limit : segment_start(SEGMENT_COUNT - 1);
+		}
+		inline Allocator get_allocator() const noexcept { return m_Allocator; }
+
+	private:
+		static constexpr inline SizeType segment_of(const SizeType index) noexcept {
+			return static_cast<SizeType>(std::bit_width(index / FirstSegment + 1)) - 1;
+		}
+		static constexpr inline SizeType segment_start(const SizeType segment) noexcept {
+			return FirstSegment * ((SizeType(1) << segment) - 1);
+		}
+		static constexpr inline SizeType segment_size(const SizeType segment) noexcept {
+			return FirstSegment << segment;
+		}
+		static constexpr inline SizeType segment_bytes(const SizeType segment) noexcept {
+			//Elements first, their slot states packed behind them.
+			return segment_size(segment) * (sizeof(Type) + sizeof(SlotState));
+		}
+		static inline SlotState& state(const Pointer block, const SizeType segment, const SizeType offset) noexcept {
+			unsigned char* States = reinterpret_cast<unsigned char*>(block + segment_size(segment));
+			return *std::launder(reinterpret_cast<SlotState*>(States) + offset);
+		}
+
+		inline Reference element(const SizeType index) const noexcept {
+			const SizeType Segment = segment_of(index);
+			return m_Segments[Segment].load(std::memory_order_acquire)[index - segment_start(Segment)];
+		}
+
+		inline Pointer acquire_segment(const SizeType segment) {
+			Pointer Block = m_Segments[segment].load(std::memory_order_acquire);
+			if (Block)
+				return Block;
+
+			//Producers allocate through their own copy, so the allocator only has to tolerate concurrent copies.
+			Allocator Local(m_Allocator);
+			Pointer Fresh = AllocatorTraits::allocate(Local, allocation_size<Allocator>(segment_bytes(segment)));
+			if (!Fresh)
+				throw std::bad_alloc();
+
+			unsigned char* States = reinterpret_cast<unsigned char*>(Fresh + segment_size(segment));
+			for (SizeType i = 0; i < segment_size(segment); i++)
+				::new (static_cast<void*>(States + i * sizeof(SlotState))) SlotState(SLOT_EMPTY);
+
+			if (m_Segments[segment].compare_exchange_strong(Block, Fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+				return Fresh;
+
+			AllocatorTraits::deallocate(Local, Fresh, allocation_size<Allocator>(segment_bytes(segment)));
+			return Block;
+		}
+
+		template<class... args>
+		inline SizeType emplace_index(args&&... arguments) {
+			//The size check and the segment allocation both happen before the slot is claimed, if either throws
+			//no slot is left reserved that nobody will ever publish or vacate.
+			SizeType Index = m_Reserved.load(std::memory_order_acquire);
+			Pointer Block = nullptr;
+			do {
+				if (Index >= max_size())
+					throw std::length_error("Max allowed container size exceeded!");
+
+				Block = acquire_segment(segment_of(Index));
+			} while (!m_Reserved.compare_exchange_weak(Index, Index + 1, std::memory_order_acq_rel, std::memory_order_acquire));
+
+			const SizeType Segment = segment_of(Index);
+			const SizeType Offset = Index - segment_start(Segment);
+
+			Allocator Local(m_Allocator);
+			try {
+				AllocatorTraits::construct(Local, Block + Offset, std::forward<args>(arguments)...);
+			}
+			catch (...) {
+				state(Block, Segment, Offset).store(SLOT_VACANT);
+				advance_published();
+				throw;
+			}
+
+			state(Block, Segment, Offset).store(SLOT_PUBLISHED);
+			advance_published();
+			return Index;
+		}
+
+		inline void advance_published() noexcept {
+			//Moves size() over every finished slot, on behalf of whichever producer finished them.
+			//Slot stores and these loads are sequentially consistent, so of two producers finishing neighbouring slots
+			//at the same time at least one sees the other's slot and carries size() past both.
+			SizeType Published = m_Published.load();
+			while (Published < m_Reserved.load()) {
+				const SizeType Segment = segment_of(Published);
+				const Pointer Block = m_Segments[Segment].load();
+				if (!Block || state(Block, Segment, Published - segment_start(Segment)).load() == SLOT_EMPTY)
+					return;
+
+				//On failure Published is reloaded, another producer moved it.
+				if (m_Published.compare_exchange_weak(Published, Published + 1))
+					Published++;
+			}
+		}
+
+	private:
+		std::array<std::atomic<Pointer>, SEGMENT_COUNT> m_Segments{};
+		alignas(64) std::atomic<SizeType> m_Reserved{ 0 };
+		alignas(64) std::atomic<SizeType> m_Published{ 0 };
+		Allocator m_Allocator;
+	};
+}
+
+#endif // !CONCURRENT_CONTAINER_H
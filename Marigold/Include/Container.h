@@ -1,26 +1,78 @@
 #include "Allocator.h"
+#include "GrowthPolicy.h"
+#include "Simd.h"
+#include "ThreadPool.h"
 #include <algorithm>
+#include <bit>
 #include <memory>
 #include <math.h>
 #include <concepts>
 #include <functional>
 #include <cassert>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <limits>
 
 
 #ifndef CONTAINER_H
 #define CONTAINER_H
 
+//MSVC accepts but ignores the standard attribute, empty members only collapse with its own spelling.
+#if defined(_MSC_VER)
+#define MARIGOLD_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define MARIGOLD_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
 
-namespace Marigold {
 
-	inline constexpr std::size_t REALLOCATION_FACTOR = 2;
+namespace Marigold {
 
 	template <typename T>
 	concept IsPointer = std::is_pointer_v<T>;
 
+	template <typename R, typename T>
+	concept CompatibleRange = std::ranges::input_range<R> && std::convertible_to<std::ranges::range_reference_t<R>, T>;
+
+	//Disambiguation tag for constructing a Container from a range.
+	struct FromRangeTag {
+		explicit FromRangeTag() = default;
+	};
+	inline constexpr FromRangeTag FROM_RANGE{};
+
+	//Types that can be moved to a new address with a plain memcpy, the source is then treated as dead storage.
+	//Specialize for types that are not trivially copyable but still relocatable (e.g. types owning a unique_ptr).
+	template<class T>
+	struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+	//Optional allocator hooks used by growth. try_expand grows a block without moving it,
+	//reallocate is realloc-like and may move the bytes itself, so it is only used for trivially relocatable types.
+	template<class A>
+	concept CanExpandInPlace = requires(A& allocator, typename std::allocator_traits<A>::pointer address, std::size_t size) {
+		{ allocator.try_expand(address, size, size) } -> std::convertible_to<bool>;
+	};
+	template<class A>
+	concept CanReallocate = requires(A& allocator, typename std::allocator_traits<A>::pointer address, std::size_t size) {
+		{ allocator.reallocate(address, size, size) } -> std::convertible_to<typename std::allocator_traits<A>::pointer>;
+	};
+
+	//Raw storage for the elements a Container keeps inside the object before spilling to its allocator.
+	template<class T, std::size_t Capacity>
+	struct InlineBuffer {
+		inline T* data() const noexcept { return reinterpret_cast<T*>(const_cast<unsigned char*>(m_Bytes)); }
+
+		alignas(T) unsigned char m_Bytes[sizeof(T) * Capacity];
+	};
+	template<class T>
+	struct InlineBuffer<T, 0> {
+		constexpr inline T* data() const noexcept { return nullptr; }
+	};
+
 	template<
 		class T,
-		class Alloc = CustomAllocator<T>
+		class Alloc = CustomAllocator<T>,
+		std::size_t InlineCapacity = 0,
+		class Growth = DoublingGrowth
 	>
 	class Container final {
 	public:
@@ -34,12 +86,16 @@ namespace Marigold {
 		using ReverseConstantIterator = std::reverse_iterator<ConstantPointer>;
 		using Reference = T&;
 		using ConstantReference = const T&;
-		using Predicate = std::function<bool(const T&)>;
 		using DifferenceType = std::ptrdiff_t;
-		using AllocatorTraits = std::allocator_traits<CustomAllocator<Type>>;
+		using AllocatorTraits = std::allocator_traits<Allocator>;
+
+		using GrowthPolicy = Growth;
+
+		static constexpr SizeType INLINE_CAPACITY = InlineCapacity;
 
 		static_assert(std::is_object_v<T>, "The C++ Standard forbids containers of non-object types "
 			"because of [container.requirements].");
+		static_assert(IsGrowthPolicy<Growth, Alloc>, "Growth has to provide next_capacity(capacity, required, elementSize, allocator).");
 
 	public: //Special member functions
 		constexpr Container() noexcept (noexcept(Allocator())) {};
@@ -55,19 +111,24 @@ namespace Marigold {
 		constexpr explicit Container(SizeType count, const Allocator& allocator = Allocator())
 			: m_Allocator(allocator)
 		{
-			allocate_and_copy_construct(count, count);
+			resize(count);
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		constexpr Container(InputIterator first, Sentinel last, const Allocator& allocator = Allocator())
+			: m_Allocator(allocator)
+		{
+			insert(end(), std::move(first), std::move(last));
 		}
-		template<IsPointer InputIterator>
-		constexpr Container(InputIterator first, InputIterator last, const Allocator& allocator = Allocator()) {
-			m_Allocator = allocator;
-			assign(first, last);
+		template<CompatibleRange<T> Range>
+		constexpr Container(FromRangeTag, Range&& range, const Allocator& allocator = Allocator())
+			: m_Allocator(allocator)
+		{
+			append_range(std::forward<Range>(range));
 		}
 		constexpr Container(std::initializer_list<Type> list, const Allocator& allocator = Allocator()) 
 			: m_Allocator(allocator)
 		{
-			reserve(list.size());
-			for (SizeType index = 0; index < list.size(); index++)
-				construct(begin() + index, *(list.begin() + index));
+			insert_counted(0, list.begin(), list.size());
 		}
 
 		//Copy Semantics
@@ -87,6 +148,23 @@ namespace Marigold {
 
 			uninitialized_copy_construct(other);
 		}
+		Container(const ParallelPolicy& policy, const Container& other)
+			: m_Allocator(AllocatorTraits::select_on_container_copy_construction(other.m_Allocator))
+		{
+			if (!other.m_Data)
+				return;
+
+			reserve(other.size());
+			try {
+				parallel_construct(policy, other.size(), [&other](Allocator& allocator, Pointer slot, SizeType index) {
+					AllocatorTraits::construct(allocator, slot, other.m_Data[index]);
+				});
+			}
+			catch (...) {
+				destruct_and_deallocate();
+				throw;
+			}
+		}
 		Container& operator=(const Container& other) noexcept {
 			if (this == &other)
 				return *this;
@@ -117,22 +195,18 @@ namespace Marigold {
 		}
 
 		//Move Semantics
-		constexpr Container(Container&& other) noexcept
-			: m_Allocator(std::move(other.m_Allocator)), m_Data(other.m_Data), m_Size(other.m_Size), m_Capacity(other.m_Capacity)
+		constexpr Container(Container&& other) noexcept(InlineCapacity == 0 || std::is_nothrow_move_constructible_v<Type>)
+			: m_Allocator(std::move(other.m_Allocator))
 		{
-			other.wipe();
+			steal(other);
 		}
 		constexpr Container(Container&& other, const Allocator& allocator)
 			:	m_Allocator(std::move(allocator))
 		{
 			if (allocator != other.get_allocator())
 				uninitialized_allocate_and_move(std::move(other));
-			else {
-				m_Capacity = other.m_Capacity;
-				m_Size = other.m_Size;
-				m_Data = other.m_Data;
-				other.wipe();
-			}
+			else
+				steal(other);
 		}
 		Container& operator=(Container&& other) noexcept {
 			if (this == &other)
@@ -141,17 +215,11 @@ namespace Marigold {
 			if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value) {
 				destruct_and_deallocate();
 				this->m_Allocator = other.get_allocator();
-				this->m_Data = other.m_Data;
-				this->m_Size = other.m_Size;
-				this->m_Capacity = other.m_Capacity;
-				other.wipe();
+				steal(other);
 			}
 			else if (!AllocatorTraits::propagate_on_container_move_assignment::value && this->m_Allocator == other.get_allocator()) {
 				destruct_and_deallocate();
-				this->m_Data = other.m_Data;
-				this->m_Size = other.m_Size;
-				this->m_Capacity = other.m_Capacity;
-				other.wipe();
+				steal(other);
 			}
 			else {
 				clear();
@@ -244,10 +312,8 @@ namespace Marigold {
 			else
 				IndexPosition = std::distance<ConstantPointer>(begin(), address);
 
-			if (m_Capacity == 0)
-				reserve(1);
-			else if (m_Size == m_Capacity)
-				reserve(capacity() * REALLOCATION_FACTOR);
+			if (m_Size == m_Capacity)
+				reserve(grow_capacity(m_Size + 1));
 
 			if (m_Data + IndexPosition == end()) {
 				try {
@@ -279,75 +345,57 @@ namespace Marigold {
 		}
 		constexpr inline Pointer insert(ConstantPointer position, SizeType count, ConstantReference value) {
 			assert(position <= end() && "Vector's argument out of range.");
-			if (count == 0 || !position && size() != 0)
-				return (Pointer)position;
-
-
-			if (position == begin() || !position && size() == 0) {
-				while (size() + count > capacity()) {
-					if (capacity() == 0)
-						reserve(1);
-					else
-						reserve(capacity() * REALLOCATION_FACTOR);
-				}
-
-				std::shift_right(begin(), begin() + capacity(), count);
-				for (SizeType i = 0; i < count; i++)
-					construct(begin() + i, value);
-
-				return begin();
+			const SizeType Index = std::distance<ConstantPointer>(begin(), position);
+			if (count == 0)
+				return begin() + Index;
+
+			const Type Copy(value); //value may live inside the gap being opened.
+			Pointer Gap = open_gap(Index, count);
+			SizeType Constructed = 0;
+			try {
+				for (; Constructed < count; Constructed++)
+					AllocatorTraits::construct(m_Allocator, Gap + Constructed, Copy);
 			}
-			else if (position == end()) {
-				while (size() + count > capacity()) {
-					if (capacity() == 0)
-						reserve(1);
-					else
-						reserve(capacity() * REALLOCATION_FACTOR);
-				}
-
-				for (SizeType i = 0; i < count; i++)
-					emplace_back(value);
-				return end();
+			catch (...) {
+				close_gap(Index, count, Constructed);
+				throw;
 			}
-			else {
-				SizeType index = std::distance<ConstantPointer>(begin(), position);
-				while (size() + count > capacity()) {
-					if (capacity() == 0)
-						reserve(1);
-					else
-						reserve(capacity() * REALLOCATION_FACTOR);
-				}
-
-				std::shift_right(begin() + index, begin() + capacity(), count);
-				for (SizeType i = 0; i < count; i++)
-					construct(begin() + index + i, value);
 
-				return begin() + index;
-			}
+			m_Size += count;
+			return begin() + Index;
 		}
-		template<IsPointer InputIterator>
-		constexpr Pointer insert(ConstantPointer position, InputIterator first, InputIterator last) {
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		constexpr Pointer insert(ConstantPointer position, InputIterator first, Sentinel last) {
 			assert(position <= end() && "Vector's argument out of range.");
-			if (first == last)
-				return (Pointer)position;
-
-			SizeType index = std::distance<ConstantPointer>(begin(), position);
-			SizeType targetRangeIndex = std::distance(first, last);
-			for (SizeType i = 0; i < targetRangeIndex; i++)
-				emplace(begin() + index, *(first + i));
+			const SizeType Index = std::distance<ConstantPointer>(begin(), position);
 
-			return begin() + index;
+			if constexpr (std::forward_iterator<InputIterator>) {
+				const SizeType Count = static_cast<SizeType>(std::ranges::distance(first, last));
+				return insert_counted(Index, std::move(first), Count);
+			}
+			else
+				return insert_uncounted(Index, std::move(first), std::move(last));
 		}
 		constexpr Pointer insert(ConstantPointer position, InitializerList ilist) {
 			assert(position <= end() && "Vector's argument out of range.");
-			if (ilist.size() == 0)
-				return (Pointer)position;
+			return insert_counted(std::distance<ConstantPointer>(begin(), position), ilist.begin(), ilist.size());
+		}
 
-			SizeType index = std::distance<ConstantPointer>(begin(), position);
-			for (SizeType i = 0; i < ilist.size(); i++)
-				emplace(begin() + index, *(ilist.begin() + i));
+		template<CompatibleRange<T> Range>
+		constexpr Pointer insert_range(ConstantPointer position, Range&& range) {
+			assert(position <= end() && "Vector's argument out of range.");
+			const SizeType Index = std::distance<ConstantPointer>(begin(), position);
 
-			return begin() + index;
+			if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+				const SizeType Count = static_cast<SizeType>(std::ranges::distance(range));
+				return insert_counted(Index, std::ranges::begin(range), Count);
+			}
+			else
+				return insert_uncounted(Index, std::ranges::begin(range), std::ranges::end(range));
+		}
+		template<CompatibleRange<T> Range>
+		constexpr inline void append_range(Range&& range) {
+			insert_range(end(), std::forward<Range>(range));
 		}
 
 		constexpr void assign(SizeType count, ConstantReference value) {
@@ -360,28 +408,29 @@ namespace Marigold {
 			for (SizeType i = 0; i < count; i++)
 				construct(begin() + i, value);
 		}
-		template<typename InputIt>
-		constexpr void assign(InputIt first, InputIt last) {
-			//Behavior might defer slightly from standard due to documentation errors.
-			if (size() > 0)
-				clear();
-
-			SizeType size = std::distance(first, last);
-			if (size > capacity())
-				reserve(size);
+		void assign(const ParallelPolicy& policy, SizeType count, ConstantReference value) {
+			const Type Copy(value); //value may be one of the elements about to be destroyed.
+			clear();
+			if (count > capacity())
+				reserve(count);
 
-			for (SizeType index = 0; index < size; index++)
-				construct(begin() + index, *(first + index));
+			parallel_construct(policy, count, [&Copy](Allocator& allocator, Pointer slot, SizeType) {
+				AllocatorTraits::construct(allocator, slot, Copy);
+			});
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		constexpr void assign(InputIterator first, Sentinel last) {
+			clear();
+			insert(end(), std::move(first), std::move(last));
 		}
 		constexpr void assign(InitializerList list) { 
-			if (size() > 0)
-				clear();
-
-			if (list.size() > capacity())
-				reserve(list.size());
-
-			for (SizeType i = 0; i < list.size(); i++)
-				construct(begin() + i, *(list.begin() + i));
+			clear();
+			insert_counted(0, list.begin(), list.size());
+		}
+		template<CompatibleRange<T> Range>
+		constexpr void assign_range(Range&& range) {
+			clear();
+			append_range(std::forward<Range>(range));
 		}
 
 	public: //Removal
@@ -401,41 +450,76 @@ namespace Marigold {
 		constexpr inline Pointer erase(ConstantPointer iterator) {
 			assert(iterator < end() && "Vector subscript out of range");
 
-			if (iterator == end() - 1) {
-				pop_back();
-				return end();
-			}
-			else if (iterator == begin()) {
-				destruct(iterator);
-				std::shift_left(begin(), end(), 1);
-				return  begin();
-			}
-			else {
-				SizeType index = std::distance<ConstantPointer>(begin(), iterator);
-				destruct(iterator);
-				std::shift_left(begin() + index, end(), 1);
-				return begin() + index;
-			}
+			//The tail is moved over the erased element, only the vacated last slot is destroyed.
+			const SizeType Index = std::distance<ConstantPointer>(begin(), iterator);
+			std::move(begin() + Index + 1, end(), begin() + Index);
+			destruct(end() - 1);
+			return begin() + Index;
 		}
 		constexpr inline Pointer erase(ConstantPointer first, ConstantPointer last) {
 			if (size() == 0)
 				return (Pointer)last;
 
-			assert(first <= last && "First argument is out of range");
-			assert(last <= last && "Last argument is out of range");
+			assert(first >= begin() && "First argument is out of range");
+			assert(last <= end() && "Last argument is out of range");
 			assert(first <= last && "First argument is smaller than last - Invalid input");
 
-			bool lastEqualsEnd = (last == end());
-			SizeType firstIndex = std::distance<ConstantPointer>(begin(), first);
-			SizeType lastIndex = std::distance<ConstantPointer>(begin(), last);
+			const SizeType FirstIndex = std::distance<ConstantPointer>(begin(), first);
+			const SizeType LastIndex = std::distance<ConstantPointer>(begin(), last);
+			if (first == last)
+				return begin() + FirstIndex;
+
+			const Pointer NewEnd = std::move(begin() + LastIndex, end(), begin() + FirstIndex);
+			shrink_size(static_cast<SizeType>(NewEnd - begin()));
+			return begin() + FirstIndex;
+		}
+		constexpr inline Pointer unordered_erase(ConstantPointer iterator) {
+			assert(iterator < end() && "Vector subscript out of range");
+
+			//The last element takes the erased one's place, nothing else moves. Order is not kept.
+			const Pointer Target = begin() + std::distance<ConstantPointer>(begin(), iterator);
+			if (Target != end() - 1)
+				*Target = std::move(back());
+			destruct(end() - 1);
+			return Target;
+		}
+		template<std::ranges::input_range Indices>
+			requires std::convertible_to<std::ranges::range_reference_t<Indices>, SizeType>
+		constexpr SizeType erase_indices(Indices&& indices) {
+			//indices has to be ascending without duplicates. Every kept run between two of them is moved once.
+			Pointer Write = nullptr;
+			SizeType Next = 0;
+			for (const SizeType Index : indices) {
+				assert(Index < size() && "Index out of range");
+				assert((!Write || Index >= Next) && "Indices have to be ascending and unique");
+				Write = Write ? std::move(begin() + Next, begin() + Index, Write) : begin() + Index;
+				Next = Index + 1;
+			}
+			if (!Write)
+				return 0;
 
-			Pointer endptr = end();
-			destruct(begin() + firstIndex, begin() + lastIndex);
-			std::move(begin() + lastIndex, endptr, begin() + firstIndex);
+			Write = std::move(begin() + Next, end(), Write);
+			const SizeType Removed = static_cast<SizeType>(end() - Write);
+			shrink_size(size() - Removed);
+			return Removed;
+		}
+		template<class Predicate>
+		constexpr inline SizeType remove_if(Predicate predicate) {
+			return compact(predicate);
+		}
+		template<class Val = Type>
+		constexpr inline SizeType remove(const Val& value) {
+			if constexpr (std::is_same_v<Val, Type> && Simd::HasLane<Type>) {
+				if (!std::is_constant_evaluated()) {
+					const SizeType Kept = Simd::remove(begin(), size(), value);
+					const SizeType Removed = size() - Kept;
+					shrink_size(Kept);
+					return Removed;
+				}
+			}
 
-			if (lastEqualsEnd)
-				return end();
-			return begin() + firstIndex;
+			const auto Equal = [&value](ConstantReference element) { return element == value; };
+			return compact(Equal);
 		}
 
 	public: //Iterators
@@ -469,18 +553,30 @@ namespace Marigold {
 			if (m_Capacity == m_Size)
 				return;
 
+			if (is_inline())
+				return;
+
 			if (size() == 0) {
 				deallocate_memory_block(begin(), capacity(), m_Allocator);
-				m_Capacity = 0;
-				m_Data = nullptr;
+				wipe();
 			}
+			else if (size() <= InlineCapacity)
+				return_to_inline();
 			else
 				reallocate(size());
 		}
-		constexpr inline void swap(Container<Type>& other) noexcept {
+		constexpr inline void swap(Container& other) noexcept {
 			if (this == &other)
 				return;
 
+			if (is_inline() || other.is_inline()) {
+				//Inline elements live inside the objects, they have to be moved rather than exchanged by pointer.
+				Container Temporary(std::move(other));
+				other = std::move(*this);
+				*this = std::move(Temporary);
+				return;
+			}
+
 			if constexpr (AllocatorTraits::propagate_on_container_swap::value || AllocatorTraits::is_always_equal::value)
 				std::swap(m_Allocator, other.m_Allocator);
 
@@ -490,63 +586,148 @@ namespace Marigold {
 		}
 
 		constexpr void resize(SizeType count) {
-			if (count == size())
+			if (count <= size()) {
+				shrink_size(count);
 				return;
+			}
+
+			if (count > capacity())
+				reserve(count);
 
-			if (count < size()) {
-				while (count < size())
-					pop_back();
+			if constexpr (std::is_trivially_default_constructible_v<Type> && std::is_trivially_copyable_v<Type>) {
+				std::uninitialized_value_construct_n(end(), count - size());
+				m_Size = count;
 			}
 			else {
-				if (count > capacity())
-					reserve(count);
-				while (count > size())
-					emplace_back(Type());
+				for (; m_Size < count; m_Size++)
+					AllocatorTraits::construct(m_Allocator, m_Data + m_Size);
 			}
 		}
 		constexpr void resize(SizeType count, ConstantReference value) {
-			if (count == size())
+			if (count <= size()) {
+				shrink_size(count);
 				return;
+			}
 
-			if (count < size()) {
-				while (count < size())
-					pop_back();
+			if (count > capacity()) {
+				const Type Copy(value); //value may live in the block about to be released.
+				reserve(count);
+				fill_to(count, Copy);
+			}
+			else
+				fill_to(count, value);
+		}
+		void resize(const ParallelPolicy& policy, SizeType count) {
+			if (count <= size()) {
+				shrink_size(count);
+				return;
 			}
+
+			if (count > capacity())
+				reserve(count);
+
+			parallel_construct(policy, count - size(), [](Allocator& allocator, Pointer slot, SizeType) {
+				AllocatorTraits::construct(allocator, slot);
+			});
+		}
+		void resize(const ParallelPolicy& policy, SizeType count, ConstantReference value) {
+			if (count <= size()) {
+				shrink_size(count);
+				return;
+			}
+
+			const Type Copy(value);
+			if (count > capacity())
+				reserve(count);
+
+			parallel_construct(policy, count - size(), [&Copy](Allocator& allocator, Pointer slot, SizeType) {
+				AllocatorTraits::construct(allocator, slot, Copy);
+			});
+		}
+		constexpr void resize_for_overwrite(SizeType count) {
+			//New elements are default-initialized, trivial types are left indeterminate and never touched.
+			if (count <= size()) {
+				shrink_size(count);
+				return;
+			}
+
+			if (count > capacity())
+				reserve(count);
+
+			if constexpr (std::is_trivially_default_constructible_v<Type>)
+				m_Size = count;
 			else {
-				if (count > capacity())
-					reserve(count);
-				while (count > size())
-					emplace_back(value);
+				for (; m_Size < count; m_Size++)
+					::new (static_cast<void*>(m_Data + m_Size)) Type;
 			}
 		}
 
-		constexpr inline CustomAllocator<Type> get_allocator() const noexcept { return m_Allocator; }
-		constexpr inline SizeType max_size() const noexcept { return static_cast<SizeType>(pow(2, sizeof(Pointer) * 8) / sizeof(Type) - 1); }
+		constexpr Pointer grow_uninitialized(SizeType count) {
+			//Makes room for count elements past end() without constructing them, publish them with commit_uninitialized.
+			static_assert(std::is_trivially_default_constructible_v<Type> && std::is_trivially_destructible_v<Type>,
+				"grow_uninitialized requires a trivially constructible and destructible type.");
+
+			if (size() + count > capacity())
+				reserve(grow_capacity(size() + count));
+
+			return end();
+		}
+		constexpr inline void commit_uninitialized(SizeType count) noexcept {
+			assert(size() + count <= capacity() && "Committed past the reserved capacity.");
+			m_Size += count;
+		}
+
+		constexpr inline Allocator get_allocator() const noexcept { return m_Allocator; }
+		constexpr inline SizeType max_size() const noexcept { return std::numeric_limits<SizeType>::max() / sizeof(Type); }
 		constexpr inline SizeType capacity() const noexcept { return m_Capacity; }
 		constexpr inline SizeType size() const noexcept { return m_Size; }
 		constexpr inline bool empty() const noexcept { return m_Size == 0; }
 		constexpr inline bool is_null() const noexcept { return m_Data == nullptr; }
+		constexpr inline bool is_inline() const noexcept { return InlineCapacity > 0 && m_Data == m_Inline.data(); }
+
+		template<class Predicate>
+		friend SizeType erase_if(const ParallelPolicy& policy, Container& container, Predicate predicate) {
+			//Defined here because it rebuilds the storage, see parallel_erase_if.
+			return container.parallel_erase_if(policy, predicate);
+		}
 
 	private: //Memory
 		constexpr inline Pointer allocate_memory_block(const SizeType capacity, Allocator& allocator) {
 			//No guarantee
-			Pointer NewBuffer = AllocatorTraits::allocate(allocator, sizeof(Type) * capacity);
+			Pointer NewBuffer = AllocatorTraits::allocate(allocator, allocation_size<Allocator>(sizeof(Type) * capacity));
 			if (!NewBuffer)
 				throw std::bad_alloc();
 
 			return NewBuffer;
 		}
 		constexpr inline void deallocate_memory_block(Pointer location, const SizeType size, Allocator& allocator) {
-			if (!location || size == 0)
+			if (!location || size == 0 || location == m_Inline.data())
 				return;
 
-			AllocatorTraits::deallocate(allocator, location, sizeof(Type) * size);
+			AllocatorTraits::deallocate(allocator, location, allocation_size<Allocator>(sizeof(Type) * size));
 		}
 		constexpr inline void reallocate(const SizeType capacity) {
 			//Doesnt provide guarantee
+			if (m_Capacity > 0 && !is_inline()) {
+				if constexpr (CanExpandInPlace<Allocator>) {
+					if (m_Allocator.try_expand(m_Data, sizeof(Type) * m_Capacity, sizeof(Type) * capacity)) {
+						m_Capacity = capacity;
+						return;
+					}
+				}
+				if constexpr (CanReallocate<Allocator> && IsTriviallyRelocatable<Type>::value) {
+					Pointer NewBlock = m_Allocator.reallocate(m_Data, sizeof(Type) * m_Capacity, sizeof(Type) * capacity);
+					if (!NewBlock)
+						throw std::bad_alloc();
+
+					m_Data = NewBlock;
+					m_Capacity = capacity;
+					return;
+				}
+			}
+
 			Pointer NewBlock = allocate_memory_block(capacity, m_Allocator);
-			if (m_Size > 0)
-				std::memmove(NewBlock, m_Data, m_Size * sizeof(Type));
+			relocate(NewBlock, m_Data, m_Size);
 
 			if (m_Capacity > 0)
 				deallocate_memory_block(m_Data, m_Capacity, m_Allocator);
@@ -575,10 +756,11 @@ namespace Marigold {
 		}
 		constexpr inline void swap_allocator_memory(Allocator& deallocation, Allocator& allocation, const SizeType capacity) {
 			//Uses allocation to allocate new memory block and deallocation to deallocate the old one.
-			Pointer NewBlock = allocate_memory_block(capacity, allocation);
+			if (is_inline() && capacity <= InlineCapacity)
+				return;
 
-			if (m_Size > 0)
-				std::memmove(NewBlock, m_Data, m_Size * sizeof(Type)); 
+			Pointer NewBlock = allocate_memory_block(capacity, allocation);
+			relocate(NewBlock, m_Data, m_Size);
 
 			deallocate_memory_block(m_Data, m_Capacity, deallocation);
 
@@ -620,24 +802,15 @@ namespace Marigold {
 		}
 		template<class... args>
 		constexpr inline void construct_and_shift(SizeType position, args&&... arguments) {
-			if (position > size())
+			if (position >= size())
 				throw std::invalid_argument("Invalid iterator access");
 
-			//Doesnt provide strong guarantee if type can throw.
-			if (size() + 1 == capacity()) {
-				Pointer NewBuffer = allocate_memory_block(1, m_Allocator); //Temporary block
-
-				AllocatorTraits::construct(m_Allocator, NewBuffer, arguments...);
-				std::move_backward(m_Data + position, m_Data + size(), m_Data + size() + 1);
-				*(m_Data + position) = std::move(*(NewBuffer));
-
-				deallocate_memory_block(NewBuffer, 1, m_Allocator); //Clean Temporary block
-			}
-			else {
-				AllocatorTraits::construct(m_Allocator, m_Data + size(), arguments...);
-				std::move_backward(m_Data + position, m_Data + size() + 1, m_Data + size() + 2);
-				*(m_Data + position) = std::move(*(m_Data + size() + 1));
-			}
+			//Doesnt provide strong guarantee if type can throw. Expects room for one more element.
+			//The value is built first, the arguments may refer to elements that are about to shift.
+			Type Value(std::forward<args>(arguments)...);
+			AllocatorTraits::construct(m_Allocator, m_Data + size(), std::move(*(m_Data + size() - 1)));
+			std::move_backward(m_Data + position, m_Data + size() - 1, m_Data + size());
+			*(m_Data + position) = std::move(Value);
 		}
 
 		constexpr inline void destruct(Pointer target) noexcept {
@@ -675,58 +848,434 @@ namespace Marigold {
 				}
 			}
 		}
+		constexpr inline void shrink_size(const SizeType count) noexcept {
+			if constexpr (!std::is_trivially_destructible_v<Type>) {
+				for (SizeType i = size(); i > count; i--)
+					AllocatorTraits::destroy(m_Allocator, m_Data + i - 1);
+			}
+
+			m_Size = count;
+		}
+		template<class Predicate>
+		constexpr SizeType compact(Predicate& predicate) {
+			//Stable single pass from the first removed element on. Trivially copyable elements are copied whether kept or
+			//not and the write position advances by the keep flag, so the predicate's result is never branched on.
+			Pointer Read = std::find_if(begin(), end(), [&predicate](ConstantReference element) { return static_cast<bool>(predicate(element)); });
+			if (Read == end())
+				return 0;
+
+			Pointer Write = Read;
+			if constexpr (std::is_trivially_copyable_v<Type> && std::is_copy_assignable_v<Type>) {
+				for (++Read; Read != end(); ++Read) {
+					const bool Keep = !static_cast<bool>(predicate(std::as_const(*Read)));
+					*Write = *Read;
+					Write += Keep;
+				}
+			}
+			else {
+				for (++Read; Read != end(); ++Read) {
+					if (!predicate(std::as_const(*Read)))
+						*Write++ = std::move(*Read);
+				}
+			}
+
+			const SizeType Removed = static_cast<SizeType>(end() - Write);
+			shrink_size(size() - Removed);
+			return Removed;
+		}
+		constexpr inline void fill_to(const SizeType count, ConstantReference value) {
+			if constexpr (std::is_trivially_copyable_v<Type>) {
+				std::uninitialized_fill_n(end(), count - size(), value);
+				m_Size = count;
+			}
+			else {
+				for (; m_Size < count; m_Size++)
+					AllocatorTraits::construct(m_Allocator, m_Data + m_Size, value);
+			}
+		}
 		constexpr inline void destruct_and_deallocate() {
 			clear();
 			deallocate_memory_block(m_Data, capacity(), m_Allocator);
-			m_Capacity = 0;
-			m_Data = nullptr;
+			wipe();
 		}
 
 		constexpr inline void wipe() noexcept {
-			m_Data = nullptr;
+			//Falls back to the inline buffer, which is nullptr when there is none.
+			m_Data = m_Inline.data();
 			m_Size = 0;
-			m_Capacity = 0;
+			m_Capacity = InlineCapacity;
+		}
+		constexpr inline void steal(Container& other) {
+			//Expects this to hold no elements and no allocated block.
+			if (other.is_inline()) {
+				for (SizeType i = 0; i < other.size(); i++)
+					AllocatorTraits::construct(m_Allocator, m_Data + i, std::move(*(other.m_Data + i)));
+
+				m_Size = other.m_Size;
+				other.clear();
+				return;
+			}
+
+			m_Data = other.m_Data;
+			m_Size = other.m_Size;
+			m_Capacity = other.m_Capacity;
+			other.wipe();
+		}
+		constexpr inline void return_to_inline() {
+			Pointer Block = m_Data;
+			const SizeType Capacity = m_Capacity;
+			const SizeType Size = m_Size;
+
+			m_Data = m_Inline.data();
+			m_Capacity = InlineCapacity;
+			relocate(m_Data, Block, Size);
+
+			deallocate_memory_block(Block, Capacity, m_Allocator);
+		}
+		constexpr inline void relocate(Pointer destination, Pointer source, const SizeType count) {
+			//Moves count elements to uninitialized storage and ends the lifetime of the originals.
+			//The ranges may overlap, elements are walked in the direction that never overwrites a live one.
+			if (count == 0 || destination == source)
+				return;
+
+			if constexpr (IsTriviallyRelocatable<Type>::value)
+				std::memmove(static_cast<void*>(destination), static_cast<const void*>(source), count * sizeof(Type));
+			else if (destination < source) {
+				for (SizeType i = 0; i < count; i++) {
+					AllocatorTraits::construct(m_Allocator, destination + i, std::move_if_noexcept(*(source + i)));
+					AllocatorTraits::destroy(m_Allocator, source + i);
+				}
+			}
+			else {
+				for (SizeType i = count; i > 0; i--) {
+					AllocatorTraits::construct(m_Allocator, destination + i - 1, std::move_if_noexcept(*(source + i - 1)));
+					AllocatorTraits::destroy(m_Allocator, source + i - 1);
+				}
+			}
+		}
+
+		template<class Generator>
+		inline void parallel_construct(const ParallelPolicy& policy, const SizeType count, Generator generator) {
+			//Constructs count elements past end() through generator(allocator, slot, index), expects the capacity to be reserved.
+			//Tasks construct through their own copy of the allocator, so its construct has to tolerate concurrent copies.
+			//If any element throws, the chunks already built are destroyed again and the size is left unchanged.
+			if (policy.is_serial(count)) {
+				for (SizeType i = 0; i < count; i++, m_Size++)
+					generator(m_Allocator, m_Data + m_Size, i);
+				return;
+			}
+
+			const SizeType Grain = policy.m_Grain == 0 ? 1 : policy.m_Grain;
+			const SizeType Chunks = policy.chunk_count(count);
+			const Pointer First = end();
+			std::unique_ptr<bool[]> Finished(new bool[Chunks]());
+			try {
+				policy.pool().parallel_for(Chunks, 1, [&](const SizeType firstChunk, const SizeType lastChunk) {
+					Allocator Local(m_Allocator);
+					for (SizeType Chunk = firstChunk; Chunk < lastChunk; Chunk++) {
+						const SizeType Begin = Chunk * Grain;
+						const SizeType End = Begin + Grain < count ? Begin + Grain : count;
+						SizeType i = Begin;
+						try {
+							for (; i < End; i++)
+								generator(Local, First + i, i);
+						}
+						catch (...) {
+							for (; i > Begin; i--)
+								AllocatorTraits::destroy(Local, First + i - 1);
+							throw;
+						}
+						Finished[Chunk] = true;
+					}
+				});
+			}
+			catch (...) {
+				for (SizeType Chunk = 0; Chunk < Chunks; Chunk++) {
+					if (!Finished[Chunk])
+						continue;
+
+					const SizeType Begin = Chunk * Grain;
+					const SizeType End = Begin + Grain < count ? Begin + Grain : count;
+					for (SizeType i = Begin; i < End; i++)
+						AllocatorTraits::destroy(m_Allocator, First + i);
+				}
+				throw;
+			}
+
+			m_Size += count;
+		}
+		template<class Predicate>
+		inline SizeType parallel_erase_if(const ParallelPolicy& policy, Predicate& predicate) {
+			//Survivors are flagged and counted per chunk in parallel, then moved into a new block of the same capacity
+			//at their prefix sum offsets, which briefly needs twice the memory. Inline storage and types with a throwing
+			//move stay on the serial in place algorithm.
+			const SizeType Count = size();
+			if (policy.is_serial(Count) || is_inline() || !std::is_nothrow_move_constructible_v<Type>)
+				return compact(predicate);
+
+			const SizeType Grain = policy.m_Grain == 0 ? 1 : policy.m_Grain;
+			const SizeType Chunks = policy.chunk_count(Count);
+			std::unique_ptr<bool[]> Keep(new bool[Count]);
+			std::unique_ptr<SizeType[]> Offsets(new SizeType[Chunks + 1]());
+			ThreadPool& Pool = policy.pool();
+
+			Pool.parallel_for(Chunks, 1, [&](const SizeType firstChunk, const SizeType lastChunk) {
+				for (SizeType Chunk = firstChunk; Chunk < lastChunk; Chunk++) {
+					const SizeType Begin = Chunk * Grain;
+					const SizeType End = Begin + Grain < Count ? Begin + Grain : Count;
+					SizeType Survivors = 0;
+					for (SizeType i = Begin; i < End; i++) {
+						Keep[i] = !predicate(std::as_const(m_Data[i]));
+						Survivors += Keep[i];
+					}
+					Offsets[Chunk + 1] = Survivors;
+				}
+			});
+
+			for (SizeType Chunk = 0; Chunk < Chunks; Chunk++)
+				Offsets[Chunk + 1] += Offsets[Chunk];
+			if (Offsets[Chunks] == Count)
+				return 0;
+
+			Pointer NewBlock = allocate_memory_block(m_Capacity, m_Allocator);
+			Pool.parallel_for(Chunks, 1, [&](const SizeType firstChunk, const SizeType lastChunk) {
+				Allocator Local(m_Allocator);
+				for (SizeType Chunk = firstChunk; Chunk < lastChunk; Chunk++) {
+					const SizeType Begin = Chunk * Grain;
+					const SizeType End = Begin + Grain < Count ? Begin + Grain : Count;
+					Pointer Destination = NewBlock + Offsets[Chunk];
+					for (SizeType i = Begin; i < End; i++) {
+						if (Keep[i])
+							AllocatorTraits::construct(Local, Destination++, std::move(m_Data[i]));
+						AllocatorTraits::destroy(Local, m_Data + i);
+					}
+				}
+			});
+
+			deallocate_memory_block(m_Data, m_Capacity, m_Allocator);
+			m_Data = NewBlock;
+			m_Size = Offsets[Chunks];
+			return Count - m_Size;
+		}
+
+		constexpr inline SizeType grow_capacity(const SizeType required) const noexcept {
+			const SizeType Grown = Growth::next_capacity(capacity(), required, sizeof(Type), m_Allocator);
+			if (Grown < required)
+				return required;
+
+			return Grown > max_size() && required <= max_size() ? max_size() : Grown;
+		}
+		constexpr inline Pointer open_gap(const SizeType index, const SizeType count) {
+			//Leaves count uninitialized slots at index with the tail relocated behind them, m_Size is left for the caller to commit.
+			const SizeType Required = m_Size + count;
+			if (Required > max_size())
+				throw std::length_error("Max allowed container size exceeded!");
+
+			if (Required > m_Capacity) {
+				const SizeType NewCapacity = grow_capacity(Required);
+				if (index == m_Size) {
+					reallocate(NewCapacity);
+					return m_Data + index;
+				}
+
+				//Prefix and tail go straight to their final slots, each element is touched once.
+				Pointer NewBlock = allocate_memory_block(NewCapacity, m_Allocator);
+				relocate(NewBlock, m_Data, index);
+				relocate(NewBlock + index + count, m_Data + index, m_Size - index);
+				deallocate_memory_block(m_Data, m_Capacity, m_Allocator);
+
+				m_Data = NewBlock;
+				m_Capacity = NewCapacity;
+				return m_Data + index;
+			}
+
+			relocate(m_Data + index + count, m_Data + index, m_Size - index);
+			return m_Data + index;
+		}
+		constexpr inline void close_gap(const SizeType index, const SizeType count, const SizeType constructed) noexcept {
+			//Undoes open_gap after a failed construction, destroying the constructed part of the gap.
+			for (SizeType i = 0; i < constructed; i++)
+				AllocatorTraits::destroy(m_Allocator, m_Data + index + i);
+
+			relocate(m_Data + index, m_Data + index + count, m_Size - index);
+		}
+		template<std::input_iterator InputIterator>
+		constexpr inline Pointer insert_counted(const SizeType index, InputIterator first, const SizeType count) {
+			if (count == 0)
+				return begin() + index;
+
+			Pointer Gap = open_gap(index, count);
+			SizeType Constructed = 0;
+			try {
+				for (; Constructed < count; Constructed++, ++first)
+					AllocatorTraits::construct(m_Allocator, Gap + Constructed, *first);
+			}
+			catch (...) {
+				close_gap(index, count, Constructed);
+				throw;
+			}
+
+			m_Size += count;
+			return begin() + index;
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		constexpr inline Pointer insert_uncounted(const SizeType index, InputIterator first, Sentinel last) {
+			//Single pass ranges can only be appended, the new elements are rotated into place afterwards.
+			const SizeType OldSize = m_Size;
+			for (; first != last; ++first)
+				emplace_back(*first);
+
+			std::rotate(begin() + index, begin() + OldSize, end());
+			return begin() + index;
 		}
 
 	private:
-		Pointer m_Data = nullptr;
-		SizeType m_Capacity = 0;
+		MARIGOLD_NO_UNIQUE_ADDRESS InlineBuffer<Type, InlineCapacity> m_Inline;
+		Pointer m_Data = m_Inline.data();
+		SizeType m_Capacity = InlineCapacity;
 		SizeType m_Size = 0;
 		Allocator m_Allocator;
 	};
 
+	template<class T, std::size_t N, class Alloc = CustomAllocator<T>, class Growth = DoublingGrowth>
+	using SmallContainer = Container<T, Alloc, N, Growth>;
+
+	template<class T, std::size_t Alignment>
+	using AlignedContainer = Container<T, CustomAllocator<T, Alignment>>;
+
 
 	//Non-member functions
-	template<class Type, class Allocator>
-	constexpr void swap(Container<Type, Allocator>& lhs, Container<Type, Allocator>& rhs) noexcept {
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth>
+	constexpr void swap(Container<Type, Allocator, InlineCapacity, Growth>& lhs, Container<Type, Allocator, InlineCapacity, Growth>& rhs) noexcept {
 		lhs.swap(rhs);
 	}
 
-	template<typename Type, typename Allocator, typename Val = Type>
-	constexpr Container<Type, Allocator>::SizeType erase(Container<Type, Allocator>& container, const Val& value) {
-		auto it = std::remove(container.begin(), container.end(), value);
-		auto r = std::distance(it, container.end());
-		container.erase(it, container.end());
-		return r;
+	template<typename Type, typename Allocator, std::size_t InlineCapacity, class Growth, typename Val = Type>
+	constexpr Container<Type, Allocator, InlineCapacity, Growth>::SizeType erase(Container<Type, Allocator, InlineCapacity, Growth>& container, const Val& value) {
+		return container.remove(value);
+	}
+
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth, class Predicate>
+	constexpr Container<Type, Allocator, InlineCapacity, Growth>::SizeType erase_if(Container<Type, Allocator, InlineCapacity, Growth>& container, Predicate predicate) {
+		return container.remove_if(predicate);
+	}
+
+
+	//Parallel algorithms, containers smaller than the policy threshold are processed on the calling thread.
+	//The callables run concurrently on the pool and have to be safe to call from several threads at once.
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth, class Function>
+	void for_each(const ParallelPolicy& policy, Container<Type, Allocator, InlineCapacity, Growth>& container, Function function) {
+		Type* First = container.begin();
+		if (policy.is_serial(container.size())) {
+			std::for_each(First, container.end(), function);
+			return;
+		}
+
+		policy.pool().parallel_for(container.size(), policy.m_Grain, [&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t i = begin; i < end; i++)
+				function(First[i]);
+		});
 	}
 
-	template<class Type, class Allocator, class Predicate>
-	constexpr Container<Type, Allocator>::SizeType erase_if(Container<Type, Allocator>& container, Predicate predicate) {
-		auto it = std::remove_if(container.begin(), container.end(), predicate);
-		auto r = std::distance(it, container.end());
-		container.erase(it, container.end());
-		return r;
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth, class Function>
+	void transform(const ParallelPolicy& policy, Container<Type, Allocator, InlineCapacity, Growth>& container, Function function) {
+		//In place, every element is replaced by function(element).
+		Type* First = container.begin();
+		if (policy.is_serial(container.size())) {
+			std::transform(First, container.end(), First, function);
+			return;
+		}
+
+		policy.pool().parallel_for(container.size(), policy.m_Grain, [&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t i = begin; i < end; i++)
+				First[i] = function(std::as_const(First[i]));
+		});
+	}
+
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth, class Compare = std::less<>>
+	void sort(const ParallelPolicy& policy, Container<Type, Allocator, InlineCapacity, Growth>& container, Compare compare = Compare()) {
+		//Sorts a power of two number of runs in parallel, then merges neighbouring runs pairwise, each round in parallel.
+		Type* First = container.begin();
+		const std::size_t Count = container.size();
+		if (policy.is_serial(Count)) {
+			std::sort(First, container.end(), compare);
+			return;
+		}
+
+		ThreadPool& Pool = policy.pool();
+		const std::size_t Grain = policy.m_Grain == 0 ? 1 : policy.m_Grain;
+		std::size_t Runs = std::bit_ceil(Pool.worker_count() + 1);
+		while (Runs > 1 && Count / Runs < Grain)
+			Runs /= 2;
+
+		const std::size_t RunSize = (Count + Runs - 1) / Runs;
+		const auto Bound = [Count, RunSize](const std::size_t run) { return run * RunSize < Count ? run * RunSize : Count; };
+
+		Pool.parallel_for(Runs, 1, [&](const std::size_t begin, const std::size_t end) {
+			for (std::size_t Run = begin; Run < end; Run++)
+				std::sort(First + Bound(Run), First + Bound(Run + 1), compare);
+		});
+		for (std::size_t Width = 1; Width < Runs; Width *= 2) {
+			Pool.parallel_for(Runs / (Width * 2), 1, [&](const std::size_t begin, const std::size_t end) {
+				for (std::size_t Pair = begin; Pair < end; Pair++) {
+					const std::size_t Low = Pair * Width * 2;
+					std::inplace_merge(First + Bound(Low), First + Bound(Low + Width), First + Bound(Low + Width * 2), compare);
+				}
+			});
+		}
+	}
+
+
+	//Vectorized algorithms for arithmetic containers, see Simd.h for dispatch.
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth>
+		requires std::is_arithmetic_v<Type>
+	inline Container<Type, Allocator, InlineCapacity, Growth>::ConstantPointer find(const Container<Type, Allocator, InlineCapacity, Growth>& container, const Type& value) noexcept {
+		return Simd::find(container.begin(), container.size(), value);
+	}
+
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth>
+		requires std::is_arithmetic_v<Type>
+	inline Container<Type, Allocator, InlineCapacity, Growth>::SizeType count(const Container<Type, Allocator, InlineCapacity, Growth>& container, const Type& value) noexcept {
+		return Simd::count(container.begin(), container.size(), value);
+	}
+
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth>
+		requires std::is_arithmetic_v<Type>
+	inline Type sum(const Container<Type, Allocator, InlineCapacity, Growth>& container) noexcept {
+		return Simd::sum(container.begin(), container.size());
+	}
+
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth>
+		requires std::is_arithmetic_v<Type>
+	inline Type minimum(const Container<Type, Allocator, InlineCapacity, Growth>& container) noexcept {
+		assert(!container.empty() && "minimum of an empty container");
+		return Simd::minimum(container.begin(), container.size());
+	}
+
+	template<class Type, class Allocator, std::size_t InlineCapacity, class Growth>
+		requires std::is_arithmetic_v<Type>
+	inline Type maximum(const Container<Type, Allocator, InlineCapacity, Growth>& container) noexcept {
+		assert(!container.empty() && "maximum of an empty container");
+		return Simd::maximum(container.begin(), container.size());
 	}
 
 
 	//Operators
-	template<typename Type, typename Allocator>
-	constexpr bool operator==(const Container<Type, Allocator>& lhs, const Container<Type, Allocator>& rhs) {
-		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	template<typename Type, typename Allocator, std::size_t InlineCapacity, class Growth>
+	constexpr bool operator==(const Container<Type, Allocator, InlineCapacity, Growth>& lhs, const Container<Type, Allocator, InlineCapacity, Growth>& rhs) {
+		if (lhs.size() != rhs.size())
+			return false;
+
+		if constexpr (Simd::HasLane<Type>) {
+			if (!std::is_constant_evaluated())
+				return Simd::equal(lhs.begin(), rhs.begin(), lhs.size());
+		}
+
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 	}
 
-	template<typename Type, typename Allocator>
-	constexpr std::_Synth_three_way_result<Type> operator<=>(const Container<Type, Allocator>& lhs, const Container<Type, Allocator>& rhs) {
+	template<typename Type, typename Allocator, std::size_t InlineCapacity, class Growth>
+	constexpr std::_Synth_three_way_result<Type> operator<=>(const Container<Type, Allocator, InlineCapacity, Growth>& lhs, const Container<Type, Allocator, InlineCapacity, Growth>& rhs) {
 		return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::_Synth_three_way());
 	}
 
@@ -0,0 +1,818 @@
+#include "Container.h"
+#include <cstddef>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+
+namespace Marigold {
+
+	struct SortedUniqueTag {
+		explicit SortedUniqueTag() = default;
+	};
+	inline constexpr SortedUniqueTag SORTED_UNIQUE{};
+
+	template<class Compare>
+	concept IsTransparent = requires { typename Compare::is_transparent; };
+
+	//First position whose key isBefore rejects, keys have to be partitioned by it. The step is a multiply instead of a
+	//branch, so the loop runs the same log2(count) iterations whatever the keys are and never mispredicts.
+	template<class Key, class IsBefore>
+	inline std::size_t branchless_partition_point(const Key* keys, std::size_t count, IsBefore& isBefore) {
+		if (count == 0)
+			return 0;
+
+		const Key* Base = keys;
+		while (count > 1) {
+			const std::size_t Half = count / 2;
+			Base += static_cast<std::size_t>(static_cast<bool>(isBefore(Base[Half]))) * Half;
+			count -= Half;
+		}
+
+		return static_cast<std::size_t>(Base - keys) + static_cast<bool>(isBefore(*Base));
+	}
+
+	//Search policies of the flat containers. Index<Key, Alloc> is rebuilt from the sorted keys after every change
+	//and answers partition_point over them.
+	struct BranchlessSearch {
+		template<class Key, class Alloc>
+		struct Index {
+			Index() noexcept = default;
+			explicit Index(const Alloc&) noexcept {}
+
+			inline void rebuild(const Key*, std::size_t) noexcept {}
+
+			template<class IsBefore>
+			inline std::size_t partition_point(const Key* keys, const std::size_t count, IsBefore isBefore) const {
+				return branchless_partition_point(keys, count, isBefore);
+			}
+		};
+	};
+
+	//Keeps a second copy of the keys in Eytzinger (breadth first) order, so the first levels of every search share a
+	//few cache lines and each step's two children sit next to each other. Rebuilding is linear, which suits tables
+	//built in bulk and then mostly searched. Costs a key and an index per element.
+	struct EytzingerSearch {
+		template<class Key, class Alloc>
+		class Index {
+		public:
+			static_assert(std::is_copy_constructible_v<Key>, "The Eytzinger layout stores copies of the keys.");
+
+			Index() noexcept = default;
+			explicit Index(const Alloc& allocator) noexcept
+				: m_Nodes(NodeAllocator(allocator)), m_Ranks(RankAllocator(allocator))
+			{
+			}
+
+			void rebuild(const Key* keys, const std::size_t count) {
+				//Until the rebuild finishes, searches fall back to the sorted keys.
+				m_Valid = false;
+				m_Nodes.clear();
+				m_Ranks.clear();
+				if (count == 0)
+					return;
+
+				//Node k (one based) has children 2k and 2k + 1. An in order walk hands out the sorted ranks.
+				m_Ranks.resize(count + 1);
+				std::size_t Node = 1;
+				while (2 * Node <= count)
+					Node *= 2;
+				for (std::size_t Rank = 0; Rank < count; Rank++) {
+					m_Ranks[Node] = Rank;
+					if (2 * Node + 1 <= count) {
+						Node = 2 * Node + 1;
+						while (2 * Node <= count)
+							Node *= 2;
+					}
+					else
+						Node >>= std::countr_zero(~Node) + 1;
+				}
+				m_Ranks[0] = count; //A search that only ever went right ends on node 0.
+
+				//Slot 0 is padding so node k sits at index k, which keeps the descendants prefetched together in one line.
+				m_Nodes.reserve(count + 1);
+				m_Nodes.push_back(keys[0]);
+				for (std::size_t i = 1; i <= count; i++)
+					m_Nodes.push_back(keys[m_Ranks[i]]);
+				m_Valid = true;
+			}
+
+			template<class IsBefore>
+			inline std::size_t partition_point(const Key* keys, const std::size_t count, IsBefore isBefore) const {
+				if (!m_Valid)
+					return branchless_partition_point(keys, count, isBefore);
+
+				//Descends to a leaf, the path is recorded in the bits of Node. The answer is the last node where the
+				//search went left, stripping the trailing right turns and that left turn recovers it.
+				//The descendants PREFETCH_DEPTH levels down are contiguous, they are requested while this level compares.
+				const std::uintptr_t Base = reinterpret_cast<std::uintptr_t>(m_Nodes.data());
+				std::size_t Node = 1;
+				while (Node <= count) {
+					Simd::prefetch(reinterpret_cast<const void*>(Base + (Node << PREFETCH_DEPTH) * sizeof(Key)));
+					Node = 2 * Node + static_cast<std::size_t>(static_cast<bool>(isBefore(m_Nodes[Node])));
+				}
+				Node >>= std::countr_zero(~Node) + 1;
+				return m_Ranks[Node];
+			}
+
+		private:
+			//Levels below the current node whose keys fit in one cache line.
+			static constexpr std::size_t PREFETCH_DEPTH = sizeof(Key) < 64 ? std::countr_zero(std::bit_floor(64 / sizeof(Key))) : 0;
+
+			using NodeAllocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Key>;
+			using RankAllocator = typename std::allocator_traits<Alloc>::template rebind_alloc<std::size_t>;
+
+			Container<Key, NodeAllocator> m_Nodes;
+			Container<std::size_t, RankAllocator> m_Ranks;
+			bool m_Valid = false;
+		};
+	};
+
+
+	//Sorted unique keys in one Container. Lookups are binary searches through the Search policy, single inserts and
+	//erases shift the tail like the underlying Container. Bulk inserts append, sort the new keys and merge them in a
+	//single pass, so building from n unsorted keys is O(n log n) instead of n shifting inserts.
+	template<
+		class Key,
+		class Compare = std::less<Key>,
+		class Search = BranchlessSearch,
+		class Alloc = CustomAllocator<Key>
+	>
+	class FlatSet final {
+	public:
+		using KeyType = Key;
+		using Type = Key;
+		using KeyCompare = Compare;
+		using Allocator = Alloc;
+		using Storage = Container<Key, Alloc>;
+		using SizeType = std::size_t;
+		using DifferenceType = std::ptrdiff_t;
+		using ConstantPointer = const Key*;
+		using ConstantReference = const Key&;
+		using Iterator = ConstantPointer;
+		using ConstantIterator = ConstantPointer;
+		using ReverseIterator = std::reverse_iterator<ConstantPointer>;
+		using ReverseConstantIterator = ReverseIterator;
+		using InitializerList = std::initializer_list<Key>;
+
+	private:
+		using SearchIndex = typename Search::template Index<Key, Alloc>;
+
+	public: //Special member functions
+		FlatSet() = default;
+		explicit FlatSet(const Compare& compare, const Alloc& allocator = Alloc())
+			: m_Keys(allocator), m_Index(allocator), m_Compare(compare)
+		{
+		}
+		explicit FlatSet(const Alloc& allocator)
+			: FlatSet(Compare(), allocator)
+		{
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		FlatSet(InputIterator first, Sentinel last, const Compare& compare = Compare(), const Alloc& allocator = Alloc())
+			: FlatSet(compare, allocator)
+		{
+			insert(std::move(first), std::move(last));
+		}
+		template<std::ranges::input_range Range>
+		FlatSet(FromRangeTag, Range&& range, const Compare& compare = Compare(), const Alloc& allocator = Alloc())
+			: FlatSet(compare, allocator)
+		{
+			insert_range(std::forward<Range>(range));
+		}
+		FlatSet(InitializerList list, const Compare& compare = Compare(), const Alloc& allocator = Alloc())
+			: FlatSet(list.begin(), list.end(), compare, allocator)
+		{
+		}
+		//Adopts keys that are already sorted and unique under compare, only debug builds check.
+		FlatSet(SortedUniqueTag, Storage keys, const Compare& compare = Compare())
+			: m_Keys(std::move(keys)), m_Index(m_Keys.get_allocator()), m_Compare(compare)
+		{
+			assert(std::ranges::adjacent_find(m_Keys, [this](const Key& lhs, const Key& rhs) { return !m_Compare(lhs, rhs); }) == m_Keys.end()
+				&& "Keys have to be sorted and unique");
+			reindex();
+		}
+
+		FlatSet& operator=(InitializerList list) {
+			clear();
+			insert(list);
+			return *this;
+		}
+
+	public: //Lookup
+		inline Iterator find(const Key& key) const { return find_key(key); }
+		template<class K> requires IsTransparent<Compare>
+		inline Iterator find(const K& key) const { return find_key(key); }
+
+		inline bool contains(const Key& key) const { return find_key(key) != end(); }
+		template<class K> requires IsTransparent<Compare>
+		inline bool contains(const K& key) const { return find_key(key) != end(); }
+
+		inline SizeType count(const Key& key) const { return contains(key) ? 1 : 0; }
+		template<class K> requires IsTransparent<Compare>
+		inline SizeType count(const K& key) const { return contains(key) ? 1 : 0; }
+
+		inline Iterator lower_bound(const Key& key) const { return begin() + lower_index(key); }
+		template<class K> requires IsTransparent<Compare>
+		inline Iterator lower_bound(const K& key) const { return begin() + lower_index(key); }
+
+		inline Iterator upper_bound(const Key& key) const { return begin() + upper_index(key); }
+		template<class K> requires IsTransparent<Compare>
+		inline Iterator upper_bound(const K& key) const { return begin() + upper_index(key); }
+
+		inline std::pair<Iterator, Iterator> equal_range(const Key& key) const { return { lower_bound(key), upper_bound(key) }; }
+		template<class K> requires IsTransparent<Compare>
+		inline std::pair<Iterator, Iterator> equal_range(const K& key) const { return { lower_bound(key), upper_bound(key) }; }
+
+	public: //Insertion
+		inline std::pair<Iterator, bool> insert(const Key& key) { return insert_key(key); }
+		inline std::pair<Iterator, bool> insert(Key&& key) { return insert_key(std::move(key)); }
+		template<class... args>
+		inline std::pair<Iterator, bool> emplace(args&&... arguments) {
+			return insert_key(Key(std::forward<args>(arguments)...));
+		}
+
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		void insert(InputIterator first, Sentinel last) {
+			//Keys already present win over new equal ones, among new equal keys the first one wins.
+			const SizeType Old = size();
+			m_Keys.insert(m_Keys.end(), std::move(first), std::move(last));
+			merge_tail(Old);
+		}
+		inline void insert(InitializerList list) {
+			insert(list.begin(), list.end());
+		}
+		template<std::ranges::input_range Range>
+		inline void insert_range(Range&& range) {
+			const SizeType Old = size();
+			m_Keys.append_range(std::forward<Range>(range));
+			merge_tail(Old);
+		}
+
+	public: //Removal
+		inline Iterator erase(Iterator position) {
+			const SizeType Index = static_cast<SizeType>(position - begin());
+			m_Keys.erase(position);
+			reindex();
+			return begin() + Index;
+		}
+		inline Iterator erase(Iterator first, Iterator last) {
+			const SizeType Index = static_cast<SizeType>(first - begin());
+			m_Keys.erase(first, last);
+			reindex();
+			return begin() + Index;
+		}
+		inline SizeType erase(const Key& key) {
+			const Iterator Found = find_key(key);
+			if (Found == end())
+				return 0;
+
+			erase(Found);
+			return 1;
+		}
+		template<class Predicate>
+		inline SizeType erase_if(Predicate predicate) {
+			//Removal keeps the order, the keys stay sorted.
+			const SizeType Removed = m_Keys.remove_if(predicate);
+			if (Removed)
+				reindex();
+			return Removed;
+		}
+		inline void clear() noexcept {
+			m_Keys.clear();
+			m_Index = SearchIndex(m_Keys.get_allocator());
+		}
+		//Hands the sorted keys over and leaves the set empty.
+		inline Storage extract() {
+			Storage Result = std::move(m_Keys);
+			clear();
+			return Result;
+		}
+
+	public: //Iterators
+		inline Iterator begin() const noexcept { return m_Keys.begin(); }
+		inline Iterator cbegin() const noexcept { return begin(); }
+		inline Iterator end() const noexcept { return m_Keys.end(); }
+		inline Iterator cend() const noexcept { return end(); }
+
+		inline ReverseIterator rbegin() const noexcept { return ReverseIterator(end()); }
+		inline ReverseIterator crbegin() const noexcept { return rbegin(); }
+		inline ReverseIterator rend() const noexcept { return ReverseIterator(begin()); }
+		inline ReverseIterator crend() const noexcept { return rend(); }
+
+	public: //Capacity
+		inline void reserve(SizeType capacity) { m_Keys.reserve(capacity); }
+		inline void shrink_to_fit() { m_Keys.shrink_to_fit(); }
+		inline void swap(FlatSet& other) noexcept {
+			m_Keys.swap(other.m_Keys);
+			std::swap(m_Index, other.m_Index);
+			std::swap(m_Compare, other.m_Compare);
+		}
+
+		inline SizeType size() const noexcept { return m_Keys.size(); }
+		inline bool empty() const noexcept { return m_Keys.empty(); }
+		inline SizeType capacity() const noexcept { return m_Keys.capacity(); }
+		inline SizeType max_size() const noexcept { return m_Keys.max_size(); }
+		inline ConstantPointer data() const noexcept { return m_Keys.data(); }
+		inline const Storage& keys() const noexcept { return m_Keys; }
+		inline KeyCompare key_comp() const { return m_Compare; }
+		inline Allocator get_allocator() const noexcept { return m_Keys.get_allocator(); }
+
+	private:
+		template<class K>
+		inline SizeType lower_index(const K& key) const {
+			return m_Index.partition_point(m_Keys.data(), size(), [this, &key](const Key& element) { return m_Compare(element, key); });
+		}
+		template<class K>
+		inline SizeType upper_index(const K& key) const {
+			return m_Index.partition_point(m_Keys.data(), size(), [this, &key](const Key& element) { return !m_Compare(key, element); });
+		}
+		template<class K>
+		inline Iterator find_key(const K& key) const {
+			const SizeType Index = lower_index(key);
+			if (Index == size() || m_Compare(key, m_Keys[Index]))
+				return end();
+
+			return begin() + Index;
+		}
+
+		template<class K>
+		std::pair<Iterator, bool> insert_key(K&& key) {
+			const SizeType Index = lower_index(key);
+			if (Index < size() && !m_Compare(key, m_Keys[Index]))
+				return { begin() + Index, false };
+
+			m_Keys.insert(m_Keys.begin() + Index, std::forward<K>(key));
+			reindex();
+			return { begin() + Index, true };
+		}
+
+		void merge_tail(const SizeType old) {
+			//Sorts the appended keys, merges them behind the old ones and drops the duplicates in one sweep.
+			const auto Less = [this](const Key& lhs, const Key& rhs) { return static_cast<bool>(m_Compare(lhs, rhs)); };
+			const auto Pointer = m_Keys.begin();
+			std::stable_sort(Pointer + old, m_Keys.end(), Less);
+			std::inplace_merge(Pointer, Pointer + old, m_Keys.end(), Less);
+			const auto Last = std::unique(Pointer, m_Keys.end(), [&Less](const Key& lhs, const Key& rhs) { return !Less(lhs, rhs); });
+			m_Keys.erase(Last, m_Keys.end());
+			reindex();
+		}
+		inline void reindex() {
+			m_Index.rebuild(m_Keys.data(), size());
+		}
+
+	private:
+		Storage m_Keys;
+		SearchIndex m_Index;
+		Compare m_Compare;
+	};
+
+
+	//Sorted unique keys and their values in two parallel Containers, so searches only touch keys. Iterators yield
+	//pairs of references, the key const. Ordering and search work like FlatSet.
+	template<
+		class Key,
+		class Value,
+		class Compare = std::less<Key>,
+		class Search = BranchlessSearch,
+		class Alloc = CustomAllocator<Key>
+	>
+	class FlatMap final {
+	public:
+		using KeyType = Key;
+		using MappedType = Value;
+		using ValueType = std::pair<Key, Value>;
+		using KeyCompare = Compare;
+		using Allocator = Alloc;
+		using KeyStorage = Container<Key, Alloc>;
+		using ValueStorage = Container<Value, typename std::allocator_traits<Alloc>::template rebind_alloc<Value>>;
+		using SizeType = std::size_t;
+		using DifferenceType = std::ptrdiff_t;
+		using Reference = std::pair<const Key&, Value&>;
+		using ConstantReference = std::pair<const Key&, const Value&>;
+		using InitializerList = std::initializer_list<ValueType>;
+
+	private:
+		using SearchIndex = typename Search::template Index<Key, Alloc>;
+
+		//Holds a key and a value pointer, dereferencing zips them into a pair of references.
+		template<bool IsConstant>
+		class BasicIterator {
+		public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::input_iterator_tag; //References are proxies.
+			using value_type = ValueType;
+			using difference_type = DifferenceType;
+			using reference = std::conditional_t<IsConstant, ConstantReference, Reference>;
+			using ValuePointer = std::conditional_t<IsConstant, const Value*, Value*>;
+
+			struct ArrowProxy {
+				reference m_Reference;
+				inline const reference* operator->() const noexcept { return std::addressof(m_Reference); }
+			};
+
+		public:
+			BasicIterator() noexcept = default;
+			BasicIterator(const Key* key, const ValuePointer value) noexcept
+				: m_Key(key), m_Value(value)
+			{
+			}
+			template<bool OtherConstant> requires (IsConstant && !OtherConstant)
+			BasicIterator(const BasicIterator<OtherConstant>& other) noexcept
+				: m_Key(other.m_Key), m_Value(other.m_Value)
+			{
+			}
+
+			inline reference operator*() const noexcept { return reference(*m_Key, *m_Value); }
+			inline ArrowProxy operator->() const noexcept { return ArrowProxy{ **this }; }
+			inline reference operator[](const difference_type offset) const noexcept { return *(*this + offset); }
+
+			inline BasicIterator& operator++() noexcept { ++m_Key; ++m_Value; return *this; }
+			inline BasicIterator operator++(int) noexcept { BasicIterator Previous = *this; ++*this; return Previous; }
+			inline BasicIterator& operator--() noexcept { --m_Key; --m_Value; return *this; }
+			inline BasicIterator operator--(int) noexcept { BasicIterator Previous = *this; --*this; return Previous; }
+
+			inline BasicIterator& operator+=(const difference_type offset) noexcept { m_Key += offset; m_Value += offset; return *this; }
+			inline BasicIterator& operator-=(const difference_type offset) noexcept { m_Key -= offset; m_Value -= offset; return *this; }
+
+			friend inline BasicIterator operator+(BasicIterator iterator, const difference_type offset) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator+(const difference_type offset, BasicIterator iterator) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator-(BasicIterator iterator, const difference_type offset) noexcept { return iterator -= offset; }
+			friend inline difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept { return lhs.m_Key - rhs.m_Key; }
+
+			inline bool operator==(const BasicIterator& other) const noexcept { return m_Key == other.m_Key; }
+			inline auto operator<=>(const BasicIterator& other) const noexcept { return m_Key <=> other.m_Key; }
+
+		private:
+			template<bool> friend class BasicIterator;
+			friend class FlatMap;
+
+			const Key* m_Key = nullptr;
+			ValuePointer m_Value = nullptr;
+		};
+
+	public:
+		using Iterator = BasicIterator<false>;
+		using ConstantIterator = BasicIterator<true>;
+		using ReverseIterator = std::reverse_iterator<Iterator>;
+		using ReverseConstantIterator = std::reverse_iterator<ConstantIterator>;
+
+	public: //Special member functions
+		FlatMap() = default;
+		explicit FlatMap(const Compare& compare, const Alloc& allocator = Alloc())
+			: m_Keys(allocator), m_Values(typename ValueStorage::Allocator(allocator)), m_Index(allocator), m_Compare(compare)
+		{
+		}
+		explicit FlatMap(const Alloc& allocator)
+			: FlatMap(Compare(), allocator)
+		{
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		FlatMap(InputIterator first, Sentinel last, const Compare& compare = Compare(), const Alloc& allocator = Alloc())
+			: FlatMap(compare, allocator)
+		{
+			insert(std::move(first), std::move(last));
+		}
+		template<std::ranges::input_range Range>
+		FlatMap(FromRangeTag, Range&& range, const Compare& compare = Compare(), const Alloc& allocator = Alloc())
+			: FlatMap(compare, allocator)
+		{
+			insert_range(std::forward<Range>(range));
+		}
+		FlatMap(InitializerList list, const Compare& compare = Compare(), const Alloc& allocator = Alloc())
+			: FlatMap(list.begin(), list.end(), compare, allocator)
+		{
+		}
+		//Adopts keys that are already sorted and unique under compare and their values, without checking the order.
+		FlatMap(SortedUniqueTag, KeyStorage keys, ValueStorage values, const Compare& compare = Compare())
+			: m_Keys(std::move(keys)), m_Values(std::move(values)), m_Index(m_Keys.get_allocator()), m_Compare(compare)
+		{
+			if (m_Keys.size() != m_Values.size())
+				throw std::invalid_argument("Keys and values differ in size");
+
+			reindex();
+		}
+
+	public: //Access
+		inline Value& at(const Key& key) { return at_key(*this, key); }
+		inline const Value& at(const Key& key) const { return at_key(*this, key); }
+		template<class K> requires IsTransparent<Compare>
+		inline Value& at(const K& key) { return at_key(*this, key); }
+		template<class K> requires IsTransparent<Compare>
+		inline const Value& at(const K& key) const { return at_key(*this, key); }
+
+		inline Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+		inline Value& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+	public: //Lookup
+		inline Iterator find(const Key& key) { return make_iterator(find_index(key)); }
+		inline ConstantIterator find(const Key& key) const { return make_iterator(find_index(key)); }
+		template<class K> requires IsTransparent<Compare>
+		inline Iterator find(const K& key) { return make_iterator(find_index(key)); }
+		template<class K> requires IsTransparent<Compare>
+		inline ConstantIterator find(const K& key) const { return make_iterator(find_index(key)); }
+
+		inline bool contains(const Key& key) const { return find_index(key) != size(); }
+		template<class K> requires IsTransparent<Compare>
+		inline bool contains(const K& key) const { return find_index(key) != size(); }
+
+		inline SizeType count(const Key& key) const { return contains(key) ? 1 : 0; }
+		template<class K> requires IsTransparent<Compare>
+		inline SizeType count(const K& key) const { return contains(key) ? 1 : 0; }
+
+		inline Iterator lower_bound(const Key& key) { return make_iterator(lower_index(key)); }
+		inline ConstantIterator lower_bound(const Key& key) const { return make_iterator(lower_index(key)); }
+		inline Iterator upper_bound(const Key& key) { return make_iterator(upper_index(key)); }
+		inline ConstantIterator upper_bound(const Key& key) const { return make_iterator(upper_index(key)); }
+		inline std::pair<Iterator, Iterator> equal_range(const Key& key) { return { lower_bound(key), upper_bound(key) }; }
+		inline std::pair<ConstantIterator, ConstantIterator> equal_range(const Key& key) const { return { lower_bound(key), upper_bound(key) }; }
+
+	public: //Insertion
+		inline std::pair<Iterator, bool> insert(const ValueType& value) { return try_emplace(value.first, value.second); }
+		inline std::pair<Iterator, bool> insert(ValueType&& value) { return try_emplace(std::move(value.first), std::move(value.second)); }
+
+		//Constructs the value from arguments only if key is not present yet.
+		template<class... args>
+		inline std::pair<Iterator, bool> try_emplace(const Key& key, args&&... arguments) {
+			return emplace_key(key, std::forward<args>(arguments)...);
+		}
+		template<class... args>
+		inline std::pair<Iterator, bool> try_emplace(Key&& key, args&&... arguments) {
+			return emplace_key(std::move(key), std::forward<args>(arguments)...);
+		}
+		template<class V>
+		inline std::pair<Iterator, bool> insert_or_assign(const Key& key, V&& value) {
+			const std::pair<Iterator, bool> Result = emplace_key(key, std::forward<V>(value));
+			if (!Result.second)
+				Result.first->second = std::forward<V>(value);
+			return Result;
+		}
+
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		void insert(InputIterator first, Sentinel last) {
+			//Keys already present keep their values, among new equal keys the first one wins.
+			const SizeType Old = size();
+			try {
+				for (; first != last; ++first)
+					append(*first);
+			}
+			catch (...) {
+				truncate(Old);
+				throw;
+			}
+			merge_tail(Old);
+		}
+		inline void insert(InitializerList list) {
+			insert(list.begin(), list.end());
+		}
+		template<std::ranges::input_range Range>
+		inline void insert_range(Range&& range) {
+			insert(std::ranges::begin(range), std::ranges::end(range));
+		}
+
+	public: //Removal
+		inline Iterator erase(ConstantIterator position) {
+			const SizeType Index = static_cast<SizeType>(position.m_Key - m_Keys.begin());
+			m_Keys.erase(m_Keys.begin() + Index);
+			m_Values.erase(m_Values.begin() + Index);
+			reindex();
+			return make_iterator(Index);
+		}
+		inline SizeType erase(const Key& key) {
+			const SizeType Index = find_index(key);
+			if (Index == size())
+				return 0;
+
+			erase(make_iterator(Index));
+			return 1;
+		}
+		template<class Predicate>
+		SizeType erase_if(Predicate predicate) {
+			//predicate sees the element as a pair of const references. Survivors are compacted in one pass.
+			SizeType Write = 0;
+			for (SizeType Read = 0; Read < size(); Read++) {
+				if (predicate(ConstantReference(m_Keys[Read], m_Values[Read])))
+					continue;
+
+				if (Write != Read) {
+					m_Keys[Write] = std::move(m_Keys[Read]);
+					m_Values[Write] = std::move(m_Values[Read]);
+				}
+				Write++;
+			}
+
+			const SizeType Removed = size() - Write;
+			if (Removed) {
+				truncate(Write);
+				reindex();
+			}
+			return Removed;
+		}
+		inline void clear() noexcept {
+			m_Keys.clear();
+			m_Values.clear();
+			m_Index = SearchIndex(m_Keys.get_allocator());
+		}
+
+	public: //Iterators
+		inline Iterator begin() noexcept { return make_iterator(0); }
+		inline ConstantIterator begin() const noexcept { return make_iterator(0); }
+		inline ConstantIterator cbegin() const noexcept { return begin(); }
+
+		inline Iterator end() noexcept { return make_iterator(size()); }
+		inline ConstantIterator end() const noexcept { return make_iterator(size()); }
+		inline ConstantIterator cend() const noexcept { return end(); }
+
+		inline ReverseIterator rbegin() noexcept { return ReverseIterator(end()); }
+		inline ReverseConstantIterator rbegin() const noexcept { return ReverseConstantIterator(end()); }
+		inline ReverseIterator rend() noexcept { return ReverseIterator(begin()); }
+		inline ReverseConstantIterator rend() const noexcept { return ReverseConstantIterator(begin()); }
+
+	public: //Capacity
+		inline void reserve(SizeType capacity) {
+			m_Keys.reserve(capacity);
+			m_Values.reserve(capacity);
+		}
+		inline void shrink_to_fit() {
+			m_Keys.shrink_to_fit();
+			m_Values.shrink_to_fit();
+		}
+		inline void swap(FlatMap& other) noexcept {
+			m_Keys.swap(other.m_Keys);
+			m_Values.swap(other.m_Values);
+			std::swap(m_Index, other.m_Index);
+			std::swap(m_Compare, other.m_Compare);
+		}
+
+		inline SizeType size() const noexcept { return m_Keys.size(); }
+		inline bool empty() const noexcept { return m_Keys.empty(); }
+		inline SizeType max_size() const noexcept { return m_Keys.max_size() < m_Values.max_size() ? m_Keys.max_size() : m_Values.max_size(); }
+		inline const KeyStorage& keys() const noexcept { return m_Keys; }
+		inline const ValueStorage& values() const noexcept { return m_Values; }
+		inline KeyCompare key_comp() const { return m_Compare; }
+		inline Allocator get_allocator() const noexcept { return m_Keys.get_allocator(); }
+
+	private:
+		inline Iterator make_iterator(const SizeType index) noexcept { return Iterator(m_Keys.data() + index, m_Values.data() + index); }
+		inline ConstantIterator make_iterator(const SizeType index) const noexcept { return ConstantIterator(m_Keys.data() + index, m_Values.data() + index); }
+
+		template<class K>
+		inline SizeType lower_index(const K& key) const {
+			return m_Index.partition_point(m_Keys.data(), size(), [this, &key](const Key& element) { return m_Compare(element, key); });
+		}
+		template<class K>
+		inline SizeType upper_index(const K& key) const {
+			return m_Index.partition_point(m_Keys.data(), size(), [this, &key](const Key& element) { return !m_Compare(key, element); });
+		}
+		template<class K>
+		inline SizeType find_index(const K& key) const {
+			const SizeType Index = lower_index(key);
+			if (Index == size() || m_Compare(key, m_Keys[Index]))
+				return size();
+
+			return Index;
+		}
+		template<class Self, class K>
+		static inline auto& at_key(Self& self, const K& key) {
+			const SizeType Index = self.find_index(key);
+			if (Index == self.size())
+				throw std::out_of_range("Key not found");
+
+			return self.m_Values[Index];
+		}
+
+		template<class K, class... args>
+		std::pair<Iterator, bool> emplace_key(K&& key, args&&... arguments) {
+			const SizeType Index = lower_index(key);
+			if (Index < size() && !m_Compare(key, m_Keys[Index]))
+				return { make_iterator(Index), false };
+
+			//The value goes in first, if the key then fails to go in the value is taken out again.
+			m_Values.emplace(m_Values.begin() + Index, std::forward<args>(arguments)...);
+			try {
+				m_Keys.emplace(m_Keys.begin() + Index, std::forward<K>(key));
+			}
+			catch (...) {
+				m_Values.erase(m_Values.begin() + Index);
+				throw;
+			}
+
+			reindex();
+			return { make_iterator(Index), true };
+		}
+
+		template<class Element>
+		inline void append(Element&& element) {
+			m_Keys.emplace_back(std::get<0>(std::forward<Element>(element)));
+			try {
+				m_Values.emplace_back(std::get<1>(std::forward<Element>(element)));
+			}
+			catch (...) {
+				m_Keys.pop_back();
+				throw;
+			}
+		}
+		inline void truncate(const SizeType count) noexcept {
+			m_Keys.erase(m_Keys.begin() + count, m_Keys.end());
+			m_Values.erase(m_Values.begin() + count, m_Values.end());
+		}
+
+		void merge_tail(const SizeType old) {
+			//Orders the appended entries through a permutation, then merges old and new into fresh storage in one pass,
+			//moving every key and value once and skipping duplicates.
+			const SizeType Count = size();
+			Container<SizeType, typename std::allocator_traits<Alloc>::template rebind_alloc<SizeType>> Order(typename std::allocator_traits<Alloc>::template rebind_alloc<SizeType>(m_Keys.get_allocator()));
+			Order.reserve(Count - old);
+			for (SizeType i = old; i < Count; i++)
+				Order.push_back(i);
+			std::stable_sort(Order.begin(), Order.end(), [this](const SizeType lhs, const SizeType rhs) { return static_cast<bool>(m_Compare(m_Keys[lhs], m_Keys[rhs])); });
+
+			KeyStorage Keys(m_Keys.get_allocator());
+			ValueStorage Values(m_Values.get_allocator());
+			Keys.reserve(Count);
+			Values.reserve(Count);
+
+			const auto Take = [&](const SizeType index) {
+				if (!Keys.empty() && !m_Compare(Keys.back(), m_Keys[index]))
+					return;
+
+				Keys.push_back(std::move(m_Keys[index]));
+				Values.push_back(std::move(m_Values[index]));
+			};
+
+			SizeType Left = 0;
+			SizeType Right = 0;
+			while (Left < old && Right < Order.size()) {
+				//Ties go left, old entries keep their values.
+				if (m_Compare(m_Keys[Order[Right]], m_Keys[Left]))
+					Take(Order[Right++]);
+				else
+					Take(Left++);
+			}
+			for (; Left < old; Left++)
+				Take(Left);
+			for (; Right < Order.size(); Right++)
+				Take(Order[Right]);
+
+			m_Keys = std::move(Keys);
+			m_Values = std::move(Values);
+			reindex();
+		}
+		inline void reindex() {
+			m_Index.rebuild(m_Keys.data(), size());
+		}
+
+	private:
+		KeyStorage m_Keys;
+		ValueStorage m_Values;
+		SearchIndex m_Index;
+		Compare m_Compare;
+	};
+
+
+	//Non-member functions
+	template<class Key, class Compare, class Search, class Alloc>
+	inline void swap(FlatSet<Key, Compare, Search, Alloc>& lhs, FlatSet<Key, Compare, Search, Alloc>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+	template<class Key, class Value, class Compare, class Search, class Alloc>
+	inline void swap(FlatMap<Key, Value, Compare, Search, Alloc>& lhs, FlatMap<Key, Value, Compare, Search, Alloc>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+	template<class Key, class Compare, class Search, class Alloc, class Predicate>
+	inline std::size_t erase_if(FlatSet<Key, Compare, Search, Alloc>& set, Predicate predicate) {
+		return set.erase_if(predicate);
+	}
+	template<class Key, class Value, class Compare, class Search, class Alloc, class Predicate>
+	inline std::size_t erase_if(FlatMap<Key, Value, Compare, Search, Alloc>& map, Predicate predicate) {
+		return map.erase_if(predicate);
+	}
+
+
+	//Operators
+	template<class Key, class Compare, class Search, class Alloc>
+	bool operator==(const FlatSet<Key, Compare, Search, Alloc>& lhs, const FlatSet<Key, Compare, Search, Alloc>& rhs) {
+		return lhs.keys() == rhs.keys();
+	}
+	template<class Key, class Value, class Compare, class Search, class Alloc>
+	bool operator==(const FlatMap<Key, Value, Compare, Search, Alloc>& lhs, const FlatMap<Key, Value, Compare, Search, Alloc>& rhs) {
+		return lhs.keys() == rhs.keys() && lhs.values() == rhs.values();
+	}
+}
+
+#endif // !FLAT_MAP_H
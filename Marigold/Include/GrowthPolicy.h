@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <concepts>
+#include <limits>
+
+
+#ifndef GROWTH_POLICY_H
+#define GROWTH_POLICY_H
+
+
+namespace Marigold {
+
+	inline constexpr std::size_t REALLOCATION_FACTOR = 2;
+
+	//Optional allocator hook reporting how many bytes a request of size bytes really gets.
+	template<class A>
+	concept ReportsUsableSize = requires(const A& allocator, std::size_t size) {
+		{ allocator.usable_size(size) } -> std::convertible_to<std::size_t>;
+	};
+
+	template<class A>
+	constexpr inline std::size_t usable_size(const A& allocator, const std::size_t size) noexcept {
+		if constexpr (ReportsUsableSize<A>)
+			return allocator.usable_size(size);
+		else
+			return size;
+	}
+
+	//Growth policies pick the capacity a Container reallocates to once required elements no longer fit.
+	//The result is never smaller than required, callers clamp it against max_size().
+	template<class Policy, class A>
+	concept IsGrowthPolicy = requires(std::size_t count, const A& allocator) {
+		{ Policy::next_capacity(count, count, count, allocator) } -> std::convertible_to<std::size_t>;
+	};
+
+	template<std::size_t Numerator, std::size_t Denominator>
+	struct GeometricGrowth {
+		static_assert(Denominator > 0 && Numerator > Denominator, "Growth factor has to be larger than 1.");
+
+		template<class A>
+		static constexpr inline std::size_t next_capacity(const std::size_t capacity, const std::size_t required, const std::size_t elementSize, const A&) noexcept {
+			const std::size_t Limit = std::numeric_limits<std::size_t>::max() / elementSize;
+			std::size_t Grown = Limit;
+			if (capacity <= Limit / Numerator)
+				Grown = capacity * Numerator / Denominator;
+
+			return Grown > required ? Grown : required;
+		}
+	};
+
+	using DoublingGrowth = GeometricGrowth<REALLOCATION_FACTOR, 1>;
+	using OneAndHalfGrowth = GeometricGrowth<3, 2>;
+
+	//Geometric growth that rounds blocks of Threshold bytes or more up to whole pages, so large buffers never leave a partial page unused.
+	template<std::size_t PageSize = 4096, std::size_t Threshold = 64 * 1024, class Base = DoublingGrowth>
+	struct PageGrowth {
+		static_assert((PageSize & (PageSize - 1)) == 0, "PageSize has to be a power of two.");
+
+		template<class A>
+		static constexpr inline std::size_t next_capacity(const std::size_t capacity, const std::size_t required, const std::size_t elementSize, const A& allocator) noexcept {
+			const std::size_t Capacity = Base::next_capacity(capacity, required, elementSize, allocator);
+			if (Capacity > (std::numeric_limits<std::size_t>::max() - PageSize) / elementSize)
+				return Capacity;
+
+			const std::size_t Bytes = Capacity * elementSize;
+			if (Bytes < Threshold)
+				return Capacity;
+
+			return ((Bytes + PageSize - 1) & ~(PageSize - 1)) / elementSize;
+		}
+	};
+
+	//Rounds the grown block up to what the allocator will really hand out, using its usable_size hook when it has one.
+	template<class Base = DoublingGrowth>
+	struct SizeClassGrowth {
+		template<class A>
+		static constexpr inline std::size_t next_capacity(const std::size_t capacity, const std::size_t required, const std::size_t elementSize, const A& allocator) noexcept {
+			const std::size_t Capacity = Base::next_capacity(capacity, required, elementSize, allocator);
+			if (Capacity > std::numeric_limits<std::size_t>::max() / elementSize)
+				return Capacity;
+
+			const std::size_t Usable = usable_size(allocator, Capacity * elementSize) / elementSize;
+			return Usable > Capacity ? Usable : Capacity;
+		}
+	};
+}
+
+#endif // !GROWTH_POLICY_H
@@ -0,0 +1,538 @@
+#include "Container.h"
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+#ifndef INPLACE_CONTAINER_H
+#define INPLACE_CONTAINER_H
+
+
+namespace Marigold {
+
+	//Element types an InplaceContainer can keep in a plain array, which is what constant evaluation needs.
+	template<class T>
+	inline constexpr bool IS_TRIVIAL_INPLACE = std::is_trivially_default_constructible_v<T> && std::is_trivially_copyable_v<T>;
+
+	template<class T, std::size_t Capacity, bool Trivial = IS_TRIVIAL_INPLACE<T>>
+	struct InplaceStorage {
+		constexpr InplaceStorage() noexcept {
+			//A constant needs every element initialized, at run time the array is left untouched.
+			if (std::is_constant_evaluated()) {
+				for (T& Element : m_Elements)
+					std::construct_at(std::addressof(Element));
+			}
+		}
+
+		constexpr inline T* data() noexcept { return m_Elements; }
+		constexpr inline const T* data() const noexcept { return m_Elements; }
+
+		T m_Elements[Capacity > 0 ? Capacity : 1];
+	};
+	//Elements are constructed and destroyed by the container, the union keeps the array from doing it.
+	template<class T, std::size_t Capacity>
+	struct InplaceStorage<T, Capacity, false> {
+		constexpr InplaceStorage() noexcept {}
+		constexpr InplaceStorage(const InplaceStorage&) noexcept {}
+		constexpr InplaceStorage& operator=(const InplaceStorage&) noexcept { return *this; }
+		constexpr ~InplaceStorage() {}
+
+		constexpr inline T* data() noexcept { return m_Elements; }
+		constexpr inline const T* data() const noexcept { return m_Elements; }
+
+		union {
+			T m_Elements[Capacity > 0 ? Capacity : 1];
+		};
+	};
+
+	//Smallest unsigned type able to count to Capacity.
+	template<std::size_t Capacity>
+	using InplaceSize = std::conditional_t<Capacity <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+		std::conditional_t<Capacity <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+		std::conditional_t<Capacity <= std::numeric_limits<std::uint32_t>::max(), std::uint32_t, std::size_t>>>;
+
+	//Container with the API of Container and room for Capacity elements inside the object, it never allocates.
+	//Growing past Capacity throws std::length_error, the try_ functions report it by returning nullptr instead.
+	//Trivial element types make it a literal type usable in constant evaluation, e.g. to build lookup tables,
+	//and keep it trivially copyable and destructible.
+	template<class T, std::size_t Capacity>
+	class InplaceContainer final {
+	public:
+		using Type = T;
+		using SizeType = std::size_t;
+		using Pointer = Type*;
+		using ConstantPointer = const T*;
+		using InitializerList = std::initializer_list<Type>;
+		using ReverseIterator = std::reverse_iterator<Pointer>;
+		using ReverseConstantIterator = std::reverse_iterator<ConstantPointer>;
+		using Reference = T&;
+		using ConstantReference = const T&;
+		using DifferenceType = std::ptrdiff_t;
+
+		static constexpr SizeType CAPACITY = Capacity;
+
+		static_assert(std::is_object_v<T>, "The C++ Standard forbids containers of non-object types "
+			"because of [container.requirements].");
+
+	private:
+		static constexpr bool TRIVIAL = IS_TRIVIAL_INPLACE<T>;
+
+	public: //Special member functions
+		constexpr InplaceContainer() noexcept = default;
+		constexpr InplaceContainer(const SizeType count, ConstantReference value) {
+			assign(count, value);
+		}
+		constexpr explicit InplaceContainer(const SizeType count) {
+			resize(count);
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		constexpr InplaceContainer(InputIterator first, Sentinel last) {
+			insert(end(), std::move(first), std::move(last));
+		}
+		template<CompatibleRange<T> Range>
+		constexpr InplaceContainer(FromRangeTag, Range&& range) {
+			append_range(std::forward<Range>(range));
+		}
+		constexpr InplaceContainer(InitializerList list) {
+			insert(end(), list.begin(), list.end());
+		}
+
+		//Copy Semantics
+		constexpr InplaceContainer(const InplaceContainer&) requires TRIVIAL = default;
+		constexpr InplaceContainer(const InplaceContainer& other) {
+			append_elements(other.begin(), other.end());
+		}
+		constexpr InplaceContainer& operator=(const InplaceContainer&) requires TRIVIAL = default;
+		constexpr InplaceContainer& operator=(const InplaceContainer& other) {
+			if (this != &other)
+				assign_elements(other.begin(), other.end());
+
+			return *this;
+		}
+
+		//Move Semantics, the elements are moved one by one.
+		constexpr InplaceContainer(InplaceContainer&&) requires TRIVIAL = default;
+		constexpr InplaceContainer(InplaceContainer&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+			append_elements(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+		}
+		constexpr InplaceContainer& operator=(InplaceContainer&&) requires TRIVIAL = default;
+		constexpr InplaceContainer& operator=(InplaceContainer&& other) noexcept(std::is_nothrow_move_assignable_v<Type> && std::is_nothrow_move_constructible_v<Type>) {
+			if (this != &other)
+				assign_elements(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+
+			return *this;
+		}
+
+		constexpr ~InplaceContainer() requires TRIVIAL = default;
+		constexpr ~InplaceContainer() {
+			clear();
+		}
+
+		constexpr InplaceContainer& operator=(InitializerList ilist) {
+			assign_elements(ilist.begin(), ilist.end());
+			return *this;
+		}
+
+	public: //Access
+		constexpr inline Reference at(SizeType index) {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return data()[index];
+		}
+		constexpr inline ConstantReference at(SizeType index) const {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return data()[index];
+		}
+
+		constexpr inline Pointer data() noexcept { return m_Storage.data(); }
+		constexpr inline ConstantPointer data() const noexcept { return m_Storage.data(); }
+
+		constexpr inline Reference front() noexcept { return data()[0]; }
+		constexpr inline ConstantReference front() const noexcept { return data()[0]; }
+
+		constexpr inline Reference back() noexcept { return data()[m_Size - 1]; }
+		constexpr inline ConstantReference back() const noexcept { return data()[m_Size - 1]; }
+
+		constexpr inline Reference operator[](SizeType index) noexcept {
+			assert(index < size() && "Index out of range");
+			return data()[index];
+		}
+		constexpr inline ConstantReference operator[](SizeType index) const noexcept {
+			assert(index < size() && "Index out of range");
+			return data()[index];
+		}
+
+	public: //Insertion
+		constexpr inline void push_back(ConstantReference value) {
+			emplace_back(value);
+		}
+		constexpr inline void push_back(Type&& value) {
+			emplace_back(std::move(value));
+		}
+
+		template<class... args>
+		constexpr inline Reference emplace_back(args&&... arguments) {
+			if (full())
+				throw_capacity_exceeded();
+
+			return *construct_back(std::forward<args>(arguments)...);
+		}
+
+		//Return nullptr rather than throwing when the container is full, the arguments are left untouched then.
+		template<class... args>
+		constexpr inline Pointer try_emplace_back(args&&... arguments) {
+			if (full())
+				return nullptr;
+
+			return construct_back(std::forward<args>(arguments)...);
+		}
+		constexpr inline Pointer try_push_back(ConstantReference value) {
+			return try_emplace_back(value);
+		}
+		constexpr inline Pointer try_push_back(Type&& value) {
+			return try_emplace_back(std::move(value));
+		}
+
+		template<class... args>
+		constexpr inline Pointer emplace(ConstantPointer address, args&&... arguments) {
+			assert(address >= begin() && address <= end() && "Vector's argument out of range.");
+			const SizeType Index = static_cast<SizeType>(address - begin());
+			if (full())
+				throw_capacity_exceeded();
+
+			if (Index == size()) {
+				construct_back(std::forward<args>(arguments)...);
+				return begin() + Index;
+			}
+
+			//The value is built first, the arguments may refer to elements that are about to shift.
+			Type Value(std::forward<args>(arguments)...);
+			construct_back(std::move(back()));
+			std::move_backward(begin() + Index, end() - 2, end() - 1);
+			data()[Index] = std::move(Value);
+			return begin() + Index;
+		}
+
+		constexpr inline Pointer insert(ConstantPointer position, ConstantReference value) {
+			return emplace(position, value);
+		}
+		constexpr inline Pointer insert(ConstantPointer position, Type&& value) {
+			return emplace(position, std::move(value));
+		}
+		constexpr inline Pointer insert(ConstantPointer position, SizeType count, ConstantReference value) {
+			assert(position >= begin() && position <= end() && "Vector's argument out of range.");
+			const SizeType Index = static_cast<SizeType>(position - begin());
+			if (count > Capacity - size())
+				throw_capacity_exceeded();
+
+			const Type Copy(value); //value may be one of the elements being rotated.
+			const SizeType OldSize = size();
+			for (SizeType i = 0; i < count; i++)
+				append_or_rollback(OldSize, Copy);
+
+			std::rotate(begin() + Index, begin() + OldSize, end());
+			return begin() + Index;
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		constexpr Pointer insert(ConstantPointer position, InputIterator first, Sentinel last) {
+			//Appends, then rotates the new elements into place. Overflowing leaves the container as it was.
+			assert(position >= begin() && position <= end() && "Vector's argument out of range.");
+			const SizeType Index = static_cast<SizeType>(position - begin());
+			if constexpr (std::forward_iterator<InputIterator>) {
+				if (static_cast<SizeType>(std::ranges::distance(first, last)) > Capacity - size())
+					throw_capacity_exceeded();
+			}
+
+			const SizeType OldSize = size();
+			for (; first != last; ++first) {
+				if (full()) {
+					shrink_size(OldSize);
+					throw_capacity_exceeded();
+				}
+				append_or_rollback(OldSize, *first);
+			}
+
+			std::rotate(begin() + Index, begin() + OldSize, end());
+			return begin() + Index;
+		}
+		constexpr Pointer insert(ConstantPointer position, InitializerList ilist) {
+			return insert(position, ilist.begin(), ilist.end());
+		}
+
+		template<CompatibleRange<T> Range>
+		constexpr Pointer insert_range(ConstantPointer position, Range&& range) {
+			return insert(position, std::ranges::begin(range), std::ranges::end(range));
+		}
+		template<CompatibleRange<T> Range>
+		constexpr inline void append_range(Range&& range) {
+			insert_range(end(), std::forward<Range>(range));
+		}
+		//Appends as much of range as fits and returns an iterator to the first element left out.
+		template<CompatibleRange<T> Range>
+		constexpr inline std::ranges::borrowed_iterator_t<Range> try_append_range(Range&& range) {
+			auto First = std::ranges::begin(range);
+			const auto Last = std::ranges::end(range);
+			for (; First != Last && !full(); ++First)
+				construct_back(*First);
+
+			return First;
+		}
+
+		constexpr void assign(SizeType count, ConstantReference value) {
+			if (count > Capacity)
+				throw_capacity_exceeded();
+
+			const Type Copy(value); //value may be one of the elements about to be destroyed.
+			clear();
+			for (SizeType i = 0; i < count; i++)
+				construct_back(Copy);
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		constexpr void assign(InputIterator first, Sentinel last) {
+			clear();
+			insert(end(), std::move(first), std::move(last));
+		}
+		constexpr void assign(InitializerList list) {
+			assign_elements(list.begin(), list.end());
+		}
+		template<CompatibleRange<T> Range>
+		constexpr void assign_range(Range&& range) {
+			clear();
+			append_range(std::forward<Range>(range));
+		}
+
+	public: //Removal
+		constexpr inline void clear() noexcept {
+			shrink_size(0);
+		}
+		constexpr inline void pop_back() {
+			if (m_Size == 0)
+				return;
+
+			shrink_size(size() - 1);
+		}
+		constexpr inline Pointer erase(ConstantPointer iterator) {
+			assert(iterator >= begin() && iterator < end() && "Vector subscript out of range");
+
+			const SizeType Index = static_cast<SizeType>(iterator - begin());
+			std::move(begin() + Index + 1, end(), begin() + Index);
+			shrink_size(size() - 1);
+			return begin() + Index;
+		}
+		constexpr inline Pointer erase(ConstantPointer first, ConstantPointer last) {
+			assert(first >= begin() && last <= end() && first <= last && "Invalid range");
+
+			const SizeType FirstIndex = static_cast<SizeType>(first - begin());
+			const SizeType LastIndex = static_cast<SizeType>(last - begin());
+			if (first == last)
+				return begin() + FirstIndex;
+			const Pointer NewEnd = std::move(begin() + LastIndex, end(), begin() + FirstIndex);
+			shrink_size(static_cast<SizeType>(NewEnd - begin()));
+			return begin() + FirstIndex;
+		}
+
+	public: //Iterators
+		constexpr inline Pointer begin() noexcept { return data(); }
+		constexpr inline ConstantPointer begin() const noexcept { return data(); }
+		constexpr inline ConstantPointer cbegin() const noexcept { return data(); }
+
+		constexpr inline ReverseIterator rbegin() noexcept { return ReverseIterator(end()); }
+		constexpr inline ReverseConstantIterator rbegin() const noexcept { return ReverseConstantIterator(end()); }
+		constexpr inline ReverseConstantIterator crbegin() const noexcept { return rbegin(); }
+
+		constexpr inline ReverseIterator rend() noexcept { return ReverseIterator(begin()); }
+		constexpr inline ReverseConstantIterator rend() const noexcept { return ReverseConstantIterator(begin()); }
+		constexpr inline ReverseConstantIterator crend() const noexcept { return rend(); }
+
+		constexpr inline Pointer end() noexcept { return data() + m_Size; }
+		constexpr inline ConstantPointer end() const noexcept { return data() + m_Size; }
+		constexpr inline ConstantPointer cend() const noexcept { return data() + m_Size; }
+
+	public: //Capacity
+		constexpr inline void reserve(SizeType capacity) {
+			//Capacity is fixed, asking for more than it is the same overflow as inserting past it.
+			if (capacity > Capacity)
+				throw_capacity_exceeded();
+		}
+		constexpr inline void shrink_to_fit() noexcept {}
+
+		constexpr inline void swap(InplaceContainer& other) noexcept(std::is_nothrow_swappable_v<Type> && std::is_nothrow_move_constructible_v<Type>) {
+			if (this == &other)
+				return;
+
+			//Swaps the common prefix, then moves the longer tail across.
+			InplaceContainer& Longer = size() >= other.size() ? *this : other;
+			InplaceContainer& Shorter = size() >= other.size() ? other : *this;
+			const SizeType Common = Shorter.size();
+			std::swap_ranges(Shorter.begin(), Shorter.end(), Longer.begin());
+			for (SizeType i = Common; i < Longer.size(); i++)
+				Shorter.construct_back(std::move(Longer.data()[i]));
+			Longer.shrink_size(Common);
+		}
+
+		constexpr void resize(SizeType count) {
+			if (count <= size()) {
+				shrink_size(count);
+				return;
+			}
+			if (count > Capacity)
+				throw_capacity_exceeded();
+
+			while (m_Size < count)
+				construct_back();
+		}
+		constexpr void resize(SizeType count, ConstantReference value) {
+			if (count <= size()) {
+				shrink_size(count);
+				return;
+			}
+			if (count > Capacity)
+				throw_capacity_exceeded();
+
+			const Type Copy(value);
+			while (m_Size < count)
+				construct_back(Copy);
+		}
+		constexpr void resize_for_overwrite(SizeType count) {
+			//New elements are default-initialized, trivial types are left indeterminate and never touched.
+			if (count <= size()) {
+				shrink_size(count);
+				return;
+			}
+			if (count > Capacity)
+				throw_capacity_exceeded();
+
+			if constexpr (TRIVIAL) {
+				if (!std::is_constant_evaluated()) {
+					m_Size = static_cast<StoredSize>(count);
+					return;
+				}
+			}
+			for (; m_Size < count; m_Size++)
+				::new (static_cast<void*>(data() + m_Size)) Type;
+		}
+
+		static constexpr inline SizeType max_size() noexcept { return Capacity; }
+		static constexpr inline SizeType capacity() noexcept { return Capacity; }
+		constexpr inline SizeType size() const noexcept { return m_Size; }
+		constexpr inline bool empty() const noexcept { return m_Size == 0; }
+		constexpr inline bool full() const noexcept { return m_Size == Capacity; }
+
+	private:
+		using StoredSize = InplaceSize<Capacity>;
+
+		[[noreturn]] static inline void throw_capacity_exceeded() {
+			throw std::length_error("Max allowed container size exceeded!");
+		}
+
+		template<class... args>
+		constexpr inline Pointer construct_back(args&&... arguments) {
+			assert(!full() && "Constructed past the capacity.");
+			Pointer Slot = std::construct_at(data() + m_Size, std::forward<args>(arguments)...);
+			m_Size++;
+			return Slot;
+		}
+		template<class Value>
+		constexpr inline void append_or_rollback(const SizeType oldSize, Value&& value) {
+			try {
+				construct_back(std::forward<Value>(value));
+			}
+			catch (...) {
+				shrink_size(oldSize);
+				throw;
+			}
+		}
+		constexpr inline void shrink_size(const SizeType count) noexcept {
+			if constexpr (!std::is_trivially_destructible_v<Type>) {
+				for (SizeType i = m_Size; i > count; i--)
+					std::destroy_at(data() + i - 1);
+			}
+
+			m_Size = static_cast<StoredSize>(count);
+		}
+
+		template<class Iterator>
+		constexpr inline void append_elements(Iterator first, Iterator last) {
+			//Only used while constructing, the destructor does not run if an element throws.
+			try {
+				for (; first != last; ++first)
+					construct_back(*first);
+			}
+			catch (...) {
+				clear();
+				throw;
+			}
+		}
+		template<class Iterator>
+		constexpr inline void assign_elements(Iterator first, Iterator last) {
+			//Assigns over the live prefix, then constructs or destroys the difference.
+			const SizeType Count = static_cast<SizeType>(std::distance(first, last));
+			if (Count > Capacity)
+				throw_capacity_exceeded();
+
+			const SizeType Common = Count < size() ? Count : size();
+			for (SizeType i = 0; i < Common; i++, ++first)
+				data()[i] = *first;
+			if (Count < size())
+				shrink_size(Count);
+			for (; first != last; ++first)
+				construct_back(*first);
+		}
+
+	private:
+		InplaceStorage<T, Capacity> m_Storage;
+		StoredSize m_Size = 0;
+	};
+
+
+	//Non-member functions
+	template<class Type, std::size_t Capacity>
+	constexpr void swap(InplaceContainer<Type, Capacity>& lhs, InplaceContainer<Type, Capacity>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+		lhs.swap(rhs);
+	}
+
+	template<class Type, std::size_t Capacity, class Val = Type>
+	constexpr std::size_t erase(InplaceContainer<Type, Capacity>& container, const Val& value) {
+		const auto Kept = std::remove(container.begin(), container.end(), value);
+		const auto Removed = static_cast<std::size_t>(container.end() - Kept);
+		container.erase(Kept, container.end());
+		return Removed;
+	}
+
+	template<class Type, std::size_t Capacity, class Predicate>
+	constexpr std::size_t erase_if(InplaceContainer<Type, Capacity>& container, Predicate predicate) {
+		const auto Kept = std::remove_if(container.begin(), container.end(), predicate);
+		const auto Removed = static_cast<std::size_t>(container.end() - Kept);
+		container.erase(Kept, container.end());
+		return Removed;
+	}
+
+
+	//Operators
+	template<class Type, std::size_t Capacity>
+	constexpr bool operator==(const InplaceContainer<Type, Capacity>& lhs, const InplaceContainer<Type, Capacity>& rhs) {
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template<class Type, std::size_t Capacity>
+	constexpr std::_Synth_three_way_result<Type> operator<=>(const InplaceContainer<Type, Capacity>& lhs, const InplaceContainer<Type, Capacity>& rhs) {
+		return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::_Synth_three_way());
+	}
+}
+
+#endif // !INPLACE_CONTAINER_H
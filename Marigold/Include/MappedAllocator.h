@@ -0,0 +1,217 @@
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+#ifndef MAPPED_ALLOCATOR_H
+#define MAPPED_ALLOCATOR_H
+
+
+namespace Marigold {
+
+	//Blocks below this size are not worth a system call and stay on the heap.
+	inline constexpr std::size_t MAPPED_ALLOCATION_THRESHOLD = 256 * 1024;
+
+	namespace Mapping {
+		using size_type = std::size_t;
+
+		inline size_type page_size() noexcept {
+			static const size_type PageSize = [] {
+#if defined(_WIN32)
+				SYSTEM_INFO Info;
+				GetSystemInfo(&Info);
+				return static_cast<size_type>(Info.dwPageSize);
+#else
+				return static_cast<size_type>(sysconf(_SC_PAGESIZE));
+#endif
+			}();
+			return PageSize;
+		}
+		inline size_type round_to_pages(const size_type size) noexcept {
+			const size_type PageSize = page_size();
+			return (size + PageSize - 1) & ~(PageSize - 1);
+		}
+
+		inline void* map(const size_type size, const bool hugePages) noexcept {
+#if defined(_WIN32)
+			//Large pages need SeLockMemoryPrivilege on Windows, so the hint is ignored here.
+			(void)hugePages;
+			return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+			void* Address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (Address == MAP_FAILED)
+				return nullptr;
+#if defined(MADV_HUGEPAGE)
+			if (hugePages)
+				madvise(Address, size, MADV_HUGEPAGE);
+#else
+			(void)hugePages;
+#endif
+			return Address;
+#endif
+		}
+		inline void unmap(void* address, const size_type size) noexcept {
+#if defined(_WIN32)
+			(void)size;
+			VirtualFree(address, 0, MEM_RELEASE);
+#else
+			munmap(address, size);
+#endif
+		}
+		inline bool extend(void* address, const size_type oldSize, const size_type newSize) noexcept {
+			//Resizes a mapping without moving it, growing is only possible when the pages behind it are free.
+			if (newSize == oldSize)
+				return true;
+#if defined(__linux__)
+			return mremap(address, oldSize, newSize, 0) != MAP_FAILED;
+#elif defined(_WIN32)
+			(void)address;
+			return false;
+#else
+			if (newSize > oldSize)
+				return false;
+
+			munmap(static_cast<unsigned char*>(address) + newSize, oldSize - newSize);
+			return true;
+#endif
+		}
+		inline void* remap(void* address, const size_type oldSize, const size_type newSize, const bool hugePages) noexcept {
+			//Moves a mapping by rewriting page tables where the platform allows it, copies otherwise.
+#if defined(__linux__)
+			void* Address = mremap(address, oldSize, newSize, MREMAP_MAYMOVE);
+			if (Address == MAP_FAILED)
+				return nullptr;
+#if defined(MADV_HUGEPAGE)
+			if (hugePages && newSize > oldSize)
+				madvise(Address, newSize, MADV_HUGEPAGE);
+#endif
+			return Address;
+#else
+			void* Address = map(newSize, hugePages);
+			if (!Address)
+				return nullptr;
+
+			std::memcpy(Address, address, oldSize < newSize ? oldSize : newSize);
+			unmap(address, oldSize);
+			return Address;
+#endif
+		}
+	}
+
+
+	//Stateless allocator backing large blocks with anonymous memory mappings. Growth of trivially relocatable
+	//element types goes through mremap on Linux, so it costs a page table update rather than a copy.
+	template<class _Alloc, bool HugePages = false>
+	class MappedAllocator final {
+	public:
+		using value_type = _Alloc;
+		using pointer = _Alloc*;
+		using size_type = std::size_t;
+		using const_pointer = const _Alloc*;
+		using const_reference = const _Alloc&;
+
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_swap			 = std::true_type;
+		using is_always_equal						 = std::true_type;
+		using is_byte_sized							 = std::true_type;
+
+		template<class U>
+		struct rebind {
+			using other = MappedAllocator<U, HugePages>;
+		};
+
+	public:
+		constexpr MappedAllocator() noexcept {}
+
+		template <class U>
+		constexpr MappedAllocator(const MappedAllocator<U, HugePages>&) noexcept {}
+
+	public:
+		[[nodiscard]] inline pointer allocate(const size_type size) {
+			if (size == 0)
+				return nullptr;
+
+			void* Block = is_mapped(size) ? Mapping::map(Mapping::round_to_pages(size), HugePages) : malloc(size);
+			if (!Block)
+				throw std::bad_alloc();
+
+			return static_cast<pointer>(Block);
+		}
+
+		template<typename T>
+		inline void deallocate(T* address, size_type size) noexcept {
+			if (!address)
+				return;
+
+			if (is_mapped(size))
+				Mapping::unmap(address, Mapping::round_to_pages(size));
+			else
+				free(address);
+		}
+
+		inline bool try_expand(pointer address, const size_type oldSize, const size_type newSize) noexcept {
+			if (!address || !is_mapped(oldSize) || !is_mapped(newSize))
+				return false;
+
+			return Mapping::extend(address, Mapping::round_to_pages(oldSize), Mapping::round_to_pages(newSize));
+		}
+		[[nodiscard]] inline pointer reallocate(pointer address, const size_type oldSize, const size_type newSize) noexcept {
+			//Only valid for trivially relocatable types.
+			if (is_mapped(oldSize) && is_mapped(newSize))
+				return static_cast<pointer>(Mapping::remap(address, Mapping::round_to_pages(oldSize), Mapping::round_to_pages(newSize), HugePages));
+			if (!is_mapped(oldSize) && !is_mapped(newSize))
+				return static_cast<pointer>(realloc(address, newSize));
+
+			//Crossing the threshold in either direction changes the backing, so the bytes have to be copied once.
+			void* Block = is_mapped(newSize) ? Mapping::map(Mapping::round_to_pages(newSize), HugePages) : malloc(newSize);
+			if (!Block)
+				return nullptr;
+
+			std::memcpy(Block, address, oldSize < newSize ? oldSize : newSize);
+			deallocate(address, oldSize);
+			return static_cast<pointer>(Block);
+		}
+
+	public:
+		constexpr inline size_type max_size() const noexcept {
+			return std::numeric_limits<size_type>::max() / sizeof(value_type);
+		}
+		inline size_type usable_size(const size_type size) const noexcept {
+			return is_mapped(size) ? Mapping::round_to_pages(size) : size;
+		}
+
+	private:
+		static constexpr inline bool is_mapped(const size_type size) noexcept {
+			return size >= MAPPED_ALLOCATION_THRESHOLD;
+		}
+	};
+
+	template <class T, class U, bool HugePages>
+	constexpr bool operator==(const MappedAllocator<T, HugePages>&, const MappedAllocator<U, HugePages>&) noexcept {
+		return true;
+	}
+
+	template <class T, class U, bool HugePages>
+	constexpr bool operator!=(const MappedAllocator<T, HugePages>&, const MappedAllocator<U, HugePages>&) noexcept {
+		return false;
+	}
+}
+
+#endif // !MAPPED_ALLOCATOR_H
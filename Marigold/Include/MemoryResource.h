@@ -0,0 +1,205 @@
+#include "ArenaAllocator.h"
+#include "PoolAllocator.h"
+#include <cstddef>
+#include <array>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+
+
+#ifndef MEMORY_RESOURCE_H
+#define MEMORY_RESOURCE_H
+
+
+namespace Marigold {
+	namespace pmr {
+
+		//Memory resources for pmr::Container and anything else taking a std::pmr::polymorphic_allocator. The
+		//allocation strategy is picked at runtime by handing a container a resource, the container type stays the same.
+
+		//Bump allocation over a MonotonicArena, deallocate only gives back the most recent block. Memory is
+		//reclaimed all at once by release() or destruction. Not thread safe.
+		class MonotonicResource : public std::pmr::memory_resource {
+		public:
+			explicit MonotonicResource(std::size_t slabSize = DEFAULT_ARENA_SLAB_SIZE) noexcept
+				: m_Arena(slabSize)
+			{
+			}
+			//Allocations are served from seed first, the arena only grows on the heap once it runs out.
+			MonotonicResource(void* seed, const std::size_t seedSize, std::size_t slabSize = DEFAULT_ARENA_SLAB_SIZE) noexcept
+				: m_Arena(seed, seedSize, slabSize)
+			{
+			}
+
+			MonotonicResource(const MonotonicResource&) = delete;
+			MonotonicResource& operator=(const MonotonicResource&) = delete;
+
+		public:
+			inline void release() noexcept { m_Arena.release(); }
+			inline const MonotonicArena& arena() const noexcept { return m_Arena; }
+
+		protected:
+			void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+				//Zero byte requests still need a unique address.
+				return m_Arena.allocate(bytes == 0 ? 1 : bytes, alignment);
+			}
+			void do_deallocate(void* address, const std::size_t bytes, const std::size_t) noexcept override {
+				m_Arena.deallocate(address, bytes == 0 ? 1 : bytes);
+			}
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+				return this == &other;
+			}
+
+		private:
+			MonotonicArena m_Arena;
+		};
+
+
+		//Seed storage has to exist before the MonotonicResource base that points into it.
+		template<std::size_t Size>
+		struct SeedBuffer {
+			alignas(std::max_align_t) unsigned char m_Seed[Size];
+		};
+
+		//MonotonicResource carrying its first Size bytes inside the object, declared as a local it allocates from the stack.
+		template<std::size_t Size>
+		class InlineMonotonicResource final : private SeedBuffer<Size>, public MonotonicResource {
+		public:
+			explicit InlineMonotonicResource(std::size_t slabSize = DEFAULT_ARENA_SLAB_SIZE) noexcept
+				: MonotonicResource(this->m_Seed, Size, slabSize)
+			{
+			}
+		};
+
+
+		//Lock used by PoolResource when it is only used from one thread.
+		struct NullMutex {
+			constexpr inline void lock() noexcept {}
+			constexpr inline void unlock() noexcept {}
+		};
+
+		//Size class pools with the classes of PoolAllocator, carved from chunks taken from an upstream resource.
+		//Blocks are aligned to their own size, so an alignment is honored by rounding the request up to it.
+		//Requests past POOL_MAX_BLOCK_SIZE go straight to upstream. Chunks return upstream on release() or destruction.
+		template<class Mutex>
+		class PoolResource final : public std::pmr::memory_resource {
+		private:
+			struct Chunk {
+				Chunk* m_Next = nullptr;
+				std::size_t m_Bytes = 0;
+				std::size_t m_Alignment = 0;
+			};
+
+			struct SizeClass {
+				Pool::Node* m_Head = nullptr;
+				Chunk* m_Chunks = nullptr;
+				std::size_t m_ChunkBlocks = 0;
+			};
+
+		public:
+			explicit PoolResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+				: m_Upstream(upstream)
+			{
+			}
+			~PoolResource() {
+				release();
+			}
+
+			PoolResource(const PoolResource&) = delete;
+			PoolResource& operator=(const PoolResource&) = delete;
+
+		public:
+			void release() noexcept {
+				for (SizeClass& Class : m_Classes) {
+					std::lock_guard<Mutex> Guard(class_lock(Class));
+					while (Class.m_Chunks) {
+						Chunk* Current = Class.m_Chunks;
+						Class.m_Chunks = Current->m_Next;
+						unsigned char* Block = reinterpret_cast<unsigned char*>(Current) + sizeof(Chunk) - Current->m_Bytes;
+						m_Upstream->deallocate(Block, Current->m_Bytes, Current->m_Alignment);
+					}
+
+					Class.m_Head = nullptr;
+					Class.m_ChunkBlocks = 0;
+				}
+			}
+			inline std::pmr::memory_resource* upstream_resource() const noexcept { return m_Upstream; }
+
+		protected:
+			void* do_allocate(std::size_t bytes, const std::size_t alignment) override {
+				bytes = bytes < alignment ? alignment : bytes;
+				if (bytes > POOL_MAX_BLOCK_SIZE)
+					return m_Upstream->allocate(bytes, alignment);
+
+				const std::size_t Index = Pool::size_class(bytes);
+				SizeClass& Class = m_Classes[Index];
+				std::lock_guard<Mutex> Guard(class_lock(Class));
+				if (!Class.m_Head)
+					carve_chunk(Class, Index);
+
+				Pool::Node* Block = Class.m_Head;
+				Class.m_Head = Block->m_Next;
+				return Block;
+			}
+			void do_deallocate(void* address, std::size_t bytes, const std::size_t alignment) noexcept override {
+				bytes = bytes < alignment ? alignment : bytes;
+				if (bytes > POOL_MAX_BLOCK_SIZE) {
+					m_Upstream->deallocate(address, bytes, alignment);
+					return;
+				}
+
+				SizeClass& Class = m_Classes[Pool::size_class(bytes)];
+				std::lock_guard<Mutex> Guard(class_lock(Class));
+				Pool::Node* Block = ::new (address) Pool::Node;
+				Block->m_Next = Class.m_Head;
+				Class.m_Head = Block;
+			}
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+				return this == &other;
+			}
+
+		private:
+			inline Mutex& class_lock(const SizeClass& sizeClass) noexcept {
+				return m_Locks[static_cast<std::size_t>(&sizeClass - m_Classes.data())];
+			}
+
+			void carve_chunk(SizeClass& sizeClass, const std::size_t index) {
+				//Called with the class lock held. Chunks double up to POOL_BATCHES_PER_CHUNK batches, the bookkeeping
+				//sits behind the blocks so they keep the chunk's alignment.
+				const std::size_t BlockSize = Pool::block_size(index);
+				const std::size_t Limit = Pool::batch_count(index) * POOL_BATCHES_PER_CHUNK;
+				const std::size_t Count = sizeClass.m_ChunkBlocks == 0 ? Pool::batch_count(index) : (sizeClass.m_ChunkBlocks * 2 < Limit ? sizeClass.m_ChunkBlocks * 2 : Limit);
+				const std::size_t Bytes = BlockSize * Count + sizeof(Chunk);
+				const std::size_t Alignment = BlockSize > alignof(Chunk) ? BlockSize : alignof(Chunk);
+
+				unsigned char* Blocks = static_cast<unsigned char*>(m_Upstream->allocate(Bytes, Alignment));
+				Chunk* NewChunk = ::new (Blocks + BlockSize * Count) Chunk;
+				NewChunk->m_Next = sizeClass.m_Chunks;
+				NewChunk->m_Bytes = Bytes;
+				NewChunk->m_Alignment = Alignment;
+				sizeClass.m_Chunks = NewChunk;
+				sizeClass.m_ChunkBlocks = Count;
+
+				Pool::Node* First = sizeClass.m_Head;
+				for (std::size_t i = Count; i > 0; i--) {
+					Pool::Node* Current = ::new (Blocks + BlockSize * (i - 1)) Pool::Node;
+					Current->m_Next = First;
+					First = Current;
+				}
+				sizeClass.m_Head = First;
+			}
+
+		private:
+			std::array<SizeClass, POOL_SIZE_CLASSES> m_Classes;
+			std::array<Mutex, POOL_SIZE_CLASSES> m_Locks;
+			std::pmr::memory_resource* m_Upstream = nullptr;
+		};
+
+		//One thread at a time, no locking.
+		using UnsynchronizedPoolResource = PoolResource<NullMutex>;
+		//Any number of threads, each size class has its own lock.
+		using SynchronizedPoolResource = PoolResource<std::mutex>;
+	}
+}
+
+#endif // !MEMORY_RESOURCE_H
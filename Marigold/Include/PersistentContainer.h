@@ -0,0 +1,517 @@
+#include "Container.h"
+#include "MappedAllocator.h"
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+
+#ifndef PERSISTENT_CONTAINER_H
+#define PERSISTENT_CONTAINER_H
+
+
+namespace Marigold {
+
+	//READ_ONLY maps shared read only pages, COPY_ON_WRITE keeps writes private to the process,
+	//READ_WRITE writes through to the file and may grow it.
+	enum class MappingMode {
+		READ_ONLY = 0,
+		COPY_ON_WRITE,
+		READ_WRITE
+	};
+
+	//Owns an open file and a single view covering all of it.
+	class MappedFile final {
+	public:
+		using size_type = std::size_t;
+
+#if defined(_WIN32)
+		using NativeHandle = HANDLE;
+#else
+		using NativeHandle = int;
+#endif
+
+	public:
+		MappedFile() noexcept = default;
+		MappedFile(const std::filesystem::path& path, const MappingMode mode)
+			: m_Mode(mode)
+		{
+			open(path, false);
+			try {
+				const size_type Size = file_size();
+				if (Size > 0)
+					map_file(Size);
+			}
+			catch (...) {
+				close();
+				throw;
+			}
+		}
+		//Creates or truncates path and maps size zeroed bytes of it for reading and writing.
+		MappedFile(const std::filesystem::path& path, const size_type size)
+			: m_Mode(MappingMode::READ_WRITE)
+		{
+			assert(size > 0 && "A new file needs at least one byte");
+
+			open(path, true);
+			try {
+				map_file(size);
+			}
+			catch (...) {
+				close();
+				throw;
+			}
+		}
+		~MappedFile() {
+			close();
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept
+			: m_File(std::exchange(other.m_File, INVALID_HANDLE)), m_Data(std::exchange(other.m_Data, nullptr)),
+			m_Size(std::exchange(other.m_Size, 0)), m_Mode(other.m_Mode), m_Anonymous(std::exchange(other.m_Anonymous, false))
+		{
+		}
+		MappedFile& operator=(MappedFile&& other) noexcept {
+			if (this != &other) {
+				close();
+				m_File = std::exchange(other.m_File, INVALID_HANDLE);
+				m_Data = std::exchange(other.m_Data, nullptr);
+				m_Size = std::exchange(other.m_Size, 0);
+				m_Mode = other.m_Mode;
+				m_Anonymous = std::exchange(other.m_Anonymous, false);
+			}
+
+			return *this;
+		}
+
+	public:
+		inline unsigned char* data() const noexcept { return m_Data; }
+		inline size_type size() const noexcept { return m_Size; }
+		inline MappingMode mode() const noexcept { return m_Mode; }
+		inline bool is_writable() const noexcept { return m_Data && m_Mode != MappingMode::READ_ONLY; }
+
+		inline void grow(const size_type size) {
+			assert(is_writable() && "Read only mappings cannot grow");
+			if (size <= m_Size)
+				return;
+
+			if (m_Mode == MappingMode::READ_WRITE) {
+				//The new view is mapped before the old one goes, a failure leaves the mapping untouched.
+				void* OldData = m_Data;
+				const size_type OldSize = m_Size;
+				m_Data = static_cast<unsigned char*>(map_view(size));
+				m_Size = size;
+				unmap_view(OldData, OldSize);
+				return;
+			}
+
+			//Private pages cannot extend the file, so the contents move to anonymous memory that no longer tracks it.
+			const size_type Size = Mapping::round_to_pages(size);
+			void* Block = m_Anonymous ? Mapping::remap(m_Data, m_Size, Size, false) : Mapping::map(Size, false);
+			if (!Block)
+				throw std::bad_alloc();
+
+			if (!m_Anonymous) {
+				std::memcpy(Block, m_Data, m_Size);
+				unmap_view(m_Data, m_Size);
+				m_Anonymous = true;
+			}
+			m_Data = static_cast<unsigned char*>(Block);
+			m_Size = Size;
+		}
+		inline void flush() {
+			//Blocks until written pages reached the file, only read-write mappings have any.
+			if (!m_Data || m_Mode != MappingMode::READ_WRITE)
+				return;
+#if defined(_WIN32)
+			if (!FlushViewOfFile(m_Data, 0) || !FlushFileBuffers(m_File))
+				throw_last_error("Failed to flush mapped file");
+#else
+			if (msync(m_Data, m_Size, MS_SYNC) != 0)
+				throw_last_error("Failed to flush mapped file");
+#endif
+		}
+
+	private:
+#if defined(_WIN32)
+		static inline const NativeHandle INVALID_HANDLE = INVALID_HANDLE_VALUE;
+#else
+		static constexpr NativeHandle INVALID_HANDLE = -1;
+#endif
+
+		[[noreturn]] static inline void throw_last_error(const char* message) {
+#if defined(_WIN32)
+			throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), message);
+#else
+			throw std::system_error(errno, std::generic_category(), message);
+#endif
+		}
+
+		inline void open(const std::filesystem::path& path, const bool create) {
+#if defined(_WIN32)
+			const DWORD Access = m_Mode == MappingMode::READ_WRITE ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+			m_File = CreateFileW(path.c_str(), Access, FILE_SHARE_READ, nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#else
+			const int Flags = (m_Mode == MappingMode::READ_WRITE ? O_RDWR : O_RDONLY) | (create ? O_CREAT | O_TRUNC : 0) | O_CLOEXEC;
+			m_File = ::open(path.c_str(), Flags, 0644);
+#endif
+			if (m_File == INVALID_HANDLE)
+				throw_last_error("Failed to open mapped file");
+		}
+		inline void close() noexcept {
+			if (m_Data) {
+				if (m_Anonymous)
+					Mapping::unmap(m_Data, m_Size);
+				else
+					unmap_view(m_Data, m_Size);
+			}
+			if (m_File != INVALID_HANDLE) {
+#if defined(_WIN32)
+				CloseHandle(m_File);
+#else
+				::close(m_File);
+#endif
+			}
+
+			m_File = INVALID_HANDLE;
+			m_Data = nullptr;
+			m_Size = 0;
+			m_Anonymous = false;
+		}
+
+		inline size_type file_size() const {
+#if defined(_WIN32)
+			LARGE_INTEGER Size;
+			if (!GetFileSizeEx(m_File, &Size))
+				throw_last_error("Failed to query mapped file size");
+			return static_cast<size_type>(Size.QuadPart);
+#else
+			struct stat Info;
+			if (fstat(m_File, &Info) != 0)
+				throw_last_error("Failed to query mapped file size");
+			return static_cast<size_type>(Info.st_size);
+#endif
+		}
+		inline void map_file(const size_type size) {
+			m_Data = static_cast<unsigned char*>(map_view(size));
+			m_Size = size;
+		}
+		inline void* map_view(const size_type size) const {
+			//Read-write views extend the file to size first, the new bytes read as zero.
+#if defined(_WIN32)
+			const std::uint64_t Size = size;
+			const HANDLE Section = CreateFileMappingW(m_File, nullptr, m_Mode == MappingMode::READ_WRITE ? PAGE_READWRITE : PAGE_READONLY,
+				static_cast<DWORD>(Size >> 32), static_cast<DWORD>(Size & 0xFFFFFFFFu), nullptr);
+			if (!Section)
+				throw_last_error("Failed to map file");
+
+			const DWORD Access = m_Mode == MappingMode::READ_WRITE ? FILE_MAP_WRITE : m_Mode == MappingMode::COPY_ON_WRITE ? FILE_MAP_COPY : FILE_MAP_READ;
+			void* Address = MapViewOfFile(Section, Access, 0, 0, size);
+			const DWORD Error = GetLastError();
+			CloseHandle(Section); //The view keeps the section alive.
+			if (!Address)
+				throw std::system_error(static_cast<int>(Error), std::system_category(), "Failed to map file");
+			return Address;
+#else
+			if (m_Mode == MappingMode::READ_WRITE && ftruncate(m_File, static_cast<off_t>(size)) != 0)
+				throw_last_error("Failed to resize mapped file");
+
+			const int Protection = m_Mode == MappingMode::READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+			void* Address = mmap(nullptr, size, Protection, m_Mode == MappingMode::READ_WRITE ? MAP_SHARED : MAP_PRIVATE, m_File, 0);
+			if (Address == MAP_FAILED)
+				throw_last_error("Failed to map file");
+			return Address;
+#endif
+		}
+		static inline void unmap_view(void* address, const size_type size) noexcept {
+#if defined(_WIN32)
+			(void)size;
+			UnmapViewOfFile(address);
+#else
+			munmap(address, size);
+#endif
+		}
+
+	private:
+		NativeHandle m_File = INVALID_HANDLE;
+		unsigned char* m_Data = nullptr;
+		size_type m_Size = 0;
+		MappingMode m_Mode = MappingMode::READ_ONLY;
+		bool m_Anonymous = false; //Copy-on-write contents that outgrew the file.
+	};
+
+
+	inline constexpr std::uint64_t PERSISTENT_MAGIC = 0x31444C474952414Dull; //"MARIGLD1" in little endian
+	inline constexpr std::uint32_t PERSISTENT_LAYOUT_VERSION = 1;
+	inline constexpr std::uint32_t PERSISTENT_BYTE_ORDER = 0x01020304u;
+
+	//Leads every persisted file, the elements follow at m_DataOffset. Fixed width fields keep it identical across builds.
+	struct PersistentHeader {
+		std::uint64_t m_Magic = PERSISTENT_MAGIC;
+		std::uint32_t m_LayoutVersion = PERSISTENT_LAYOUT_VERSION;
+		std::uint32_t m_TypeVersion = 0;
+		std::uint32_t m_ElementSize = 0;
+		std::uint32_t m_ElementAlignment = 0;
+		std::uint32_t m_ByteOrder = PERSISTENT_BYTE_ORDER;
+		std::uint32_t m_DataOffset = 0;
+		std::uint64_t m_Size = 0;
+		std::uint64_t m_Capacity = 0;
+	};
+
+	//Disambiguation tag for creating a new file rather than opening an existing one.
+	struct CreateFileTag {
+		explicit CreateFileTag() = default;
+	};
+	inline constexpr CreateFileTag CREATE_FILE{};
+
+	//Contiguous array of trivially copyable elements living in a memory mapped file. Opening maps the file and checks
+	//its header, nothing is parsed or copied and the kernel pages elements in on first touch. Bump TypeVersion whenever
+	//the meaning of T's bytes changes without changing its size.
+	template<class T, std::uint32_t TypeVersion = 0>
+	class PersistentContainer final {
+	public:
+		using Type = T;
+		using SizeType = std::size_t;
+		using Pointer = Type*;
+		using ConstantPointer = const T*;
+		using ReverseIterator = std::reverse_iterator<Pointer>;
+		using ReverseConstantIterator = std::reverse_iterator<ConstantPointer>;
+		using Reference = T&;
+		using ConstantReference = const T&;
+		using DifferenceType = std::ptrdiff_t;
+
+		static constexpr SizeType ALIGNMENT = alignof(T) > 64 ? alignof(T) : 64;
+		static constexpr SizeType DATA_OFFSET = (sizeof(PersistentHeader) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be persisted as raw bytes.");
+		static_assert(alignof(T) <= 4096, "Elements cannot be aligned past the page the mapping starts on.");
+
+	public: //Special member functions
+		PersistentContainer() noexcept = default;
+		//Maps an existing file, throws std::runtime_error if its header does not describe this element type.
+		explicit PersistentContainer(const std::filesystem::path& path, const MappingMode mode = MappingMode::READ_ONLY)
+			: m_File(path, mode)
+		{
+			validate();
+		}
+		PersistentContainer(CreateFileTag, const std::filesystem::path& path, const SizeType capacity = 0)
+			: m_File(path, file_size_for(capacity))
+		{
+			PersistentHeader& Header = header();
+			Header = PersistentHeader();
+			Header.m_TypeVersion = TypeVersion;
+			Header.m_ElementSize = static_cast<std::uint32_t>(sizeof(T));
+			Header.m_ElementAlignment = static_cast<std::uint32_t>(alignof(T));
+			Header.m_DataOffset = static_cast<std::uint32_t>(DATA_OFFSET);
+			Header.m_Capacity = (m_File.size() - DATA_OFFSET) / sizeof(T);
+		}
+		//Builds a file from range in one go, e.g. from a Container populated in memory.
+		template<CompatibleRange<T> Range>
+		PersistentContainer(CreateFileTag, const std::filesystem::path& path, Range&& range)
+			: PersistentContainer(CREATE_FILE, path, initial_capacity(range))
+		{
+			append_range(std::forward<Range>(range));
+		}
+
+		PersistentContainer(const PersistentContainer&) = delete;
+		PersistentContainer& operator=(const PersistentContainer&) = delete;
+		PersistentContainer(PersistentContainer&&) noexcept = default;
+		PersistentContainer& operator=(PersistentContainer&&) noexcept = default;
+
+	public: //Access
+		inline Reference at(SizeType index) {
+			if (index >= size())
+				throw std::out_of_range("Access Violation - index out of range");
+
+			return data()[index];
+		}
+		inline ConstantReference at(SizeType index) const {
+			if (index >= size())
+				throw std::out_of_range("Access Violation - index out of range");
+
+			return data()[index];
+		}
+
+		inline Pointer data() noexcept { return m_File.data() ? reinterpret_cast<Pointer>(m_File.data() + DATA_OFFSET) : nullptr; }
+		inline ConstantPointer data() const noexcept { return m_File.data() ? reinterpret_cast<ConstantPointer>(m_File.data() + DATA_OFFSET) : nullptr; }
+
+		inline Reference front() noexcept { return data()[0]; }
+		inline ConstantReference front() const noexcept { return data()[0]; }
+
+		inline Reference back() noexcept { return data()[size() - 1]; }
+		inline ConstantReference back() const noexcept { return data()[size() - 1]; }
+
+		inline Reference operator[](SizeType index) noexcept {
+			assert(index < size() && "Index out of range");
+			return data()[index];
+		}
+		inline ConstantReference operator[](SizeType index) const noexcept {
+			assert(index < size() && "Index out of range");
+			return data()[index];
+		}
+
+	public: //Insertion, all of these throw std::logic_error on a read only mapping.
+		inline void push_back(ConstantReference value) {
+			emplace_back(value);
+		}
+
+		template<class... args>
+		inline Reference emplace_back(args&&... arguments) {
+			reserve_for(size() + 1);
+
+			//The element is complete before the size stored in the file counts it.
+			Pointer Slot = std::construct_at(data() + size(), std::forward<args>(arguments)...);
+			header().m_Size++;
+			return *Slot;
+		}
+
+		template<CompatibleRange<T> Range>
+		inline void append_range(Range&& range) {
+			if constexpr (std::ranges::sized_range<Range>)
+				reserve_for(size() + static_cast<SizeType>(std::ranges::size(range)));
+
+			for (auto&& Value : range)
+				emplace_back(std::forward<decltype(Value)>(Value));
+		}
+
+	public: //Removal
+		inline void pop_back() {
+			assert(!empty() && "Cannot pop from an empty container");
+			writable_header().m_Size--;
+		}
+		inline void clear() {
+			if (m_File.data())
+				writable_header().m_Size = 0;
+		}
+
+	public: //Size and capacity
+		inline void resize(const SizeType count) {
+			resize(count, Type());
+		}
+		inline void resize(const SizeType count, ConstantReference value) {
+			reserve_for(count);
+			for (SizeType i = size(); i < count; i++)
+				std::construct_at(data() + i, value);
+			writable_header().m_Size = count;
+		}
+		inline void reserve(const SizeType capacity) {
+			if (capacity > this->capacity())
+				grow(capacity);
+		}
+
+		inline SizeType size() const noexcept { return m_File.data() ? static_cast<SizeType>(header().m_Size) : 0; }
+		inline SizeType capacity() const noexcept { return m_File.data() ? static_cast<SizeType>(header().m_Capacity) : 0; }
+		inline bool empty() const noexcept { return size() == 0; }
+		constexpr inline SizeType max_size() const noexcept { return (std::numeric_limits<SizeType>::max() - DATA_OFFSET) / sizeof(Type) / REALLOCATION_FACTOR; }
+
+	public: //Mapping
+		inline MappingMode mode() const noexcept { return m_File.mode(); }
+		inline bool is_open() const noexcept { return m_File.data() != nullptr; }
+		inline bool is_writable() const noexcept { return m_File.is_writable(); }
+
+		//Read-write mappings only, returns once the elements and header are on disk.
+		inline void flush() {
+			m_File.flush();
+		}
+
+	public: //Iterators
+		inline Pointer begin() noexcept { return data(); }
+		inline ConstantPointer begin() const noexcept { return data(); }
+		inline ConstantPointer cbegin() const noexcept { return data(); }
+
+		inline Pointer end() noexcept { return data() + size(); }
+		inline ConstantPointer end() const noexcept { return data() + size(); }
+		inline ConstantPointer cend() const noexcept { return data() + size(); }
+
+		inline ReverseIterator rbegin() noexcept { return ReverseIterator(end()); }
+		inline ReverseConstantIterator rbegin() const noexcept { return ReverseConstantIterator(end()); }
+		inline ReverseConstantIterator crbegin() const noexcept { return ReverseConstantIterator(end()); }
+
+		inline ReverseIterator rend() noexcept { return ReverseIterator(begin()); }
+		inline ReverseConstantIterator rend() const noexcept { return ReverseConstantIterator(begin()); }
+		inline ReverseConstantIterator crend() const noexcept { return ReverseConstantIterator(begin()); }
+
+	private:
+		inline PersistentHeader& header() noexcept { return *reinterpret_cast<PersistentHeader*>(m_File.data()); }
+		inline const PersistentHeader& header() const noexcept { return *reinterpret_cast<const PersistentHeader*>(m_File.data()); }
+		inline PersistentHeader& writable_header() {
+			if (!m_File.is_writable())
+				throw std::logic_error("Persistent container is not mapped for writing");
+
+			return header();
+		}
+
+		template<class Range>
+		static inline SizeType initial_capacity(Range& range) {
+			if constexpr (std::ranges::sized_range<Range>)
+				return static_cast<SizeType>(std::ranges::size(range));
+			else
+				return 0;
+		}
+		static inline SizeType file_size_for(const SizeType capacity) {
+			//Files are whole pages, whatever the last page has room for becomes capacity.
+			if (capacity > (std::numeric_limits<SizeType>::max() - DATA_OFFSET) / sizeof(Type))
+				throw std::length_error("Max allowed container size exceeded!");
+
+			return Mapping::round_to_pages(DATA_OFFSET + capacity * sizeof(Type));
+		}
+
+		inline void validate() const {
+			if (m_File.size() < DATA_OFFSET)
+				throw std::runtime_error("Persistent container file is too small to hold a header");
+
+			const PersistentHeader& Header = header();
+			if (Header.m_Magic != PERSISTENT_MAGIC)
+				throw std::runtime_error("File is not a persistent container");
+			if (Header.m_ByteOrder != PERSISTENT_BYTE_ORDER)
+				throw std::runtime_error("Persistent container was written with a different byte order");
+			if (Header.m_LayoutVersion != PERSISTENT_LAYOUT_VERSION)
+				throw std::runtime_error("Persistent container layout version mismatch");
+			if (Header.m_ElementSize != sizeof(T) || Header.m_ElementAlignment != alignof(T) || Header.m_DataOffset != DATA_OFFSET)
+				throw std::runtime_error("Persistent container element layout mismatch");
+			if (Header.m_TypeVersion != TypeVersion)
+				throw std::runtime_error("Persistent container element version mismatch");
+			if (Header.m_Size > Header.m_Capacity || Header.m_Capacity > (m_File.size() - DATA_OFFSET) / sizeof(T))
+				throw std::runtime_error("Persistent container file is truncated");
+		}
+
+		inline void reserve_for(const SizeType required) {
+			writable_header();
+			if (required > capacity())
+				grow(required);
+		}
+		inline void grow(SizeType required) {
+			writable_header();
+			if (required > max_size())
+				throw std::length_error("Max allowed container size exceeded!");
+
+			const SizeType Doubled = capacity() * REALLOCATION_FACTOR;
+			m_File.grow(file_size_for(required > Doubled ? required : Doubled));
+			header().m_Capacity = (m_File.size() - DATA_OFFSET) / sizeof(Type);
+		}
+
+	private:
+		MappedFile m_File;
+	};
+}
+
+#endif // !PERSISTENT_CONTAINER_H
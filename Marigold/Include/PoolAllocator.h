@@ -0,0 +1,309 @@
+#include <cstddef>
+#include <cstdlib>
+#include <array>
+#include <bit>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+
+namespace Marigold {
+
+	inline constexpr std::size_t POOL_MIN_BLOCK_SIZE = 16;
+	inline constexpr std::size_t POOL_SIZE_CLASSES = 12; //16 bytes to 32KB, powers of two.
+	inline constexpr std::size_t POOL_MAX_BLOCK_SIZE = POOL_MIN_BLOCK_SIZE << (POOL_SIZE_CLASSES - 1);
+	inline constexpr std::size_t POOL_BATCH_BYTES = 32 * 1024;
+	inline constexpr std::size_t POOL_BATCHES_PER_CHUNK = 4;
+
+	namespace Pool {
+		using size_type = std::size_t;
+
+		struct Node {
+			Node* m_Next = nullptr;
+		};
+
+		struct Batch {
+			Node* m_First = nullptr;
+			Node* m_Last = nullptr;
+			size_type m_Count = 0;
+		};
+
+		constexpr inline size_type size_class(const size_type size) noexcept {
+			return static_cast<size_type>(std::bit_width((size - 1) | (POOL_MIN_BLOCK_SIZE - 1))) - std::bit_width(POOL_MIN_BLOCK_SIZE - 1);
+		}
+		constexpr inline size_type block_size(const size_type sizeClass) noexcept {
+			return POOL_MIN_BLOCK_SIZE << sizeClass;
+		}
+		constexpr inline size_type batch_count(const size_type sizeClass) noexcept {
+			const size_type Count = POOL_BATCH_BYTES / block_size(sizeClass);
+			return Count < 2 ? 2 : (Count > 64 ? 64 : Count);
+		}
+
+
+		//Process wide pool, blocks move between it and the thread caches in batches so the lock is taken once per batch.
+		class SharedPool final {
+		private:
+			struct Chunk {
+				Chunk* m_Next = nullptr;
+			};
+			static constexpr size_type CHUNK_HEADER_SIZE = alignof(std::max_align_t) > sizeof(Chunk) ? alignof(std::max_align_t) : sizeof(Chunk);
+
+			struct SizeClass {
+				std::mutex m_Lock;
+				Node* m_Head = nullptr;
+				size_type m_Count = 0;
+			};
+
+		public:
+			SharedPool() = default;
+			~SharedPool() {
+				while (m_Chunks) {
+					Chunk* Next = m_Chunks->m_Next;
+					free(m_Chunks);
+					m_Chunks = Next;
+				}
+			}
+
+			SharedPool(const SharedPool&) = delete;
+			SharedPool& operator=(const SharedPool&) = delete;
+
+			static inline SharedPool& instance() {
+				static SharedPool Instance;
+				return Instance;
+			}
+
+		public:
+			inline Batch acquire_batch(const size_type sizeClass) {
+				SizeClass& Target = m_Classes[sizeClass];
+				std::lock_guard<std::mutex> Guard(Target.m_Lock);
+				if (!Target.m_Head)
+					carve_chunk(sizeClass);
+
+				Batch Result;
+				Result.m_First = Target.m_Head;
+				Result.m_Last = Target.m_Head;
+				Result.m_Count = 1;
+				const size_type Count = batch_count(sizeClass);
+				while (Result.m_Count < Count && Result.m_Last->m_Next) {
+					Result.m_Last = Result.m_Last->m_Next;
+					Result.m_Count++;
+				}
+
+				Target.m_Head = Result.m_Last->m_Next;
+				Target.m_Count -= Result.m_Count;
+				Result.m_Last->m_Next = nullptr;
+				return Result;
+			}
+			inline void release_batch(const size_type sizeClass, const Batch& batch) noexcept {
+				if (batch.m_Count == 0)
+					return;
+
+				SizeClass& Target = m_Classes[sizeClass];
+				std::lock_guard<std::mutex> Guard(Target.m_Lock);
+				batch.m_Last->m_Next = Target.m_Head;
+				Target.m_Head = batch.m_First;
+				Target.m_Count += batch.m_Count;
+			}
+
+		private:
+			inline void carve_chunk(const size_type sizeClass) {
+				//Called with the class lock held.
+				const size_type BlockSize = block_size(sizeClass);
+				const size_type BlockCount = batch_count(sizeClass) * POOL_BATCHES_PER_CHUNK;
+				void* Block = malloc(CHUNK_HEADER_SIZE + BlockSize * BlockCount);
+				if (!Block)
+					throw std::bad_alloc();
+
+				{
+					std::lock_guard<std::mutex> Guard(m_ChunkLock);
+					Chunk* NewChunk = ::new (Block) Chunk;
+					NewChunk->m_Next = m_Chunks;
+					m_Chunks = NewChunk;
+				}
+
+				unsigned char* Blocks = static_cast<unsigned char*>(Block) + CHUNK_HEADER_SIZE;
+				Node* First = m_Classes[sizeClass].m_Head;
+				for (size_type i = BlockCount; i > 0; i--) {
+					Node* Current = ::new (Blocks + BlockSize * (i - 1)) Node;
+					Current->m_Next = First;
+					First = Current;
+				}
+
+				m_Classes[sizeClass].m_Head = First;
+				m_Classes[sizeClass].m_Count += BlockCount;
+			}
+
+		private:
+			std::array<SizeClass, POOL_SIZE_CLASSES> m_Classes;
+			std::mutex m_ChunkLock;
+			Chunk* m_Chunks = nullptr;
+		};
+
+
+		//Per thread free lists, refilled from and drained to the shared pool one batch at a time.
+		class ThreadCache final {
+		private:
+			struct FreeList {
+				Node* m_Head = nullptr;
+				size_type m_Count = 0;
+			};
+
+		public:
+			ThreadCache() noexcept
+				: m_Shared(&SharedPool::instance())
+			{
+			}
+			~ThreadCache() {
+				for (size_type sizeClass = 0; sizeClass < POOL_SIZE_CLASSES; sizeClass++) {
+					while (m_Lists[sizeClass].m_Count > 0)
+						release_batch(sizeClass);
+				}
+			}
+
+			ThreadCache(const ThreadCache&) = delete;
+			ThreadCache& operator=(const ThreadCache&) = delete;
+
+			static inline ThreadCache& local() {
+				thread_local ThreadCache Instance;
+				return Instance;
+			}
+
+		public:
+			inline void* allocate(const size_type sizeClass) {
+				FreeList& List = m_Lists[sizeClass];
+				if (!List.m_Head) {
+					const Batch Refill = m_Shared->acquire_batch(sizeClass);
+					List.m_Head = Refill.m_First;
+					List.m_Count = Refill.m_Count;
+				}
+
+				Node* Block = List.m_Head;
+				List.m_Head = Block->m_Next;
+				List.m_Count--;
+				return Block;
+			}
+			inline void deallocate(void* address, const size_type sizeClass) noexcept {
+				FreeList& List = m_Lists[sizeClass];
+				Node* Block = ::new (address) Node;
+				Block->m_Next = List.m_Head;
+				List.m_Head = Block;
+				List.m_Count++;
+
+				//Keep at most two batches around, the rest goes back for other threads to use.
+				if (List.m_Count >= batch_count(sizeClass) * 2)
+					release_batch(sizeClass);
+			}
+
+		private:
+			inline void release_batch(const size_type sizeClass) noexcept {
+				FreeList& List = m_Lists[sizeClass];
+				const size_type Count = List.m_Count < batch_count(sizeClass) ? List.m_Count : batch_count(sizeClass);
+
+				Batch Returned;
+				Returned.m_First = List.m_Head;
+				Returned.m_Last = List.m_Head;
+				Returned.m_Count = Count;
+				for (size_type i = 1; i < Count; i++)
+					Returned.m_Last = Returned.m_Last->m_Next;
+
+				List.m_Head = Returned.m_Last->m_Next;
+				List.m_Count -= Count;
+				Returned.m_Last->m_Next = nullptr;
+				m_Shared->release_batch(sizeClass, Returned);
+			}
+
+		private:
+			std::array<FreeList, POOL_SIZE_CLASSES> m_Lists;
+			SharedPool* m_Shared = nullptr;
+		};
+	}
+
+
+	//Stateless allocator, blocks up to POOL_MAX_BLOCK_SIZE come from size class pools, anything larger goes to the heap.
+	template<class _Alloc>
+	class PoolAllocator final {
+	public:
+		using value_type = _Alloc;
+		using pointer = _Alloc*;
+		using size_type = std::size_t;
+		using const_pointer = const _Alloc*;
+		using const_reference = const _Alloc&;
+
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_swap			 = std::true_type;
+		using is_always_equal						 = std::true_type;
+		using is_byte_sized							 = std::true_type;
+
+		static_assert(alignof(_Alloc) <= POOL_MIN_BLOCK_SIZE, "PoolAllocator does not support over-aligned types.");
+
+	public:
+		constexpr PoolAllocator() noexcept {}
+
+		template <class U>
+		constexpr PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+	public:
+		[[nodiscard]] inline pointer allocate(const size_type size) {
+			if (size == 0)
+				return nullptr;
+
+			if (size > POOL_MAX_BLOCK_SIZE) {
+				void* Block = malloc(size);
+				if (!Block)
+					throw std::bad_alloc();
+				return static_cast<pointer>(Block);
+			}
+
+			return static_cast<pointer>(Pool::ThreadCache::local().allocate(Pool::size_class(size)));
+		}
+
+		template<typename T>
+		inline void deallocate(T* address, size_type size) noexcept {
+			if (!address)
+				return;
+
+			if (size > POOL_MAX_BLOCK_SIZE)
+				free(address);
+			else
+				Pool::ThreadCache::local().deallocate(address, Pool::size_class(size));
+		}
+
+		inline bool try_expand(pointer address, const size_type oldSize, const size_type newSize) noexcept {
+			//Blocks are rounded up to their size class, growth within the class needs no new block.
+			if (!address || oldSize > POOL_MAX_BLOCK_SIZE || newSize > POOL_MAX_BLOCK_SIZE)
+				return false;
+
+			return Pool::size_class(oldSize) == Pool::size_class(newSize);
+		}
+
+		constexpr inline size_type usable_size(const size_type size) const noexcept {
+			if (size == 0 || size > POOL_MAX_BLOCK_SIZE)
+				return size;
+
+			return Pool::block_size(Pool::size_class(size));
+		}
+
+	public:
+		constexpr inline size_type max_size() const noexcept {
+			return std::numeric_limits<size_type>::max() / sizeof(value_type);
+		}
+	};
+
+	template <class T, class U>
+	constexpr bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept {
+		return true;
+	}
+
+	template <class T, class U>
+	constexpr bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept {
+		return false;
+	}
+}
+
+#endif // !POOL_ALLOCATOR_H
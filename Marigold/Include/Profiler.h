@@ -0,0 +1,172 @@
+#include <cstddef>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+
+namespace Marigold::Profiler {
+
+	using size_type = std::size_t;
+
+	//Keeps the optimizer from discarding a result that is otherwise unused.
+	template<class T>
+	inline void keep(const T& value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		const volatile unsigned char Sink = *reinterpret_cast<const volatile unsigned char*>(&value);
+		(void)Sink;
+#endif
+	}
+
+	//Accumulates the time between start() and stop() calls, benchmark bodies bracket the part worth timing.
+	class Stopwatch final {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+	public:
+		inline void start() noexcept { m_Start = Clock::now(); }
+		inline void stop() noexcept { m_Elapsed += Clock::now() - m_Start; }
+
+		inline double nanoseconds() const noexcept { return std::chrono::duration<double, std::nano>(m_Elapsed).count(); }
+
+	private:
+		Clock::time_point m_Start{};
+		Clock::duration m_Elapsed{};
+	};
+
+	//Runs body(stopwatch) repetitions times and returns the median time per operation in nanoseconds.
+	template<class Body>
+	inline double measure(const size_type repetitions, const size_type operations, Body&& body) {
+		std::vector<double> Samples;
+		Samples.reserve(repetitions);
+		for (size_type i = 0; i < repetitions; i++) {
+			Stopwatch Watch;
+			body(Watch);
+			Samples.push_back(Watch.nanoseconds() / static_cast<double>(operations == 0 ? 1 : operations));
+		}
+
+		if (Samples.empty())
+			return 0.0;
+
+		std::nth_element(Samples.begin(), Samples.begin() + Samples.size() / 2, Samples.end());
+		return Samples[Samples.size() / 2];
+	}
+
+
+	struct Measurement {
+		std::string m_Case;
+		std::string m_Element;
+		size_type m_Size = 0;
+		std::string m_Contender;
+		double m_NanosecondsPerOperation = 0.0;
+		size_type m_Allocations = 0;
+		size_type m_PeakBytes = 0; //Above the bytes already live when timing started.
+	};
+
+	enum class ReportFormat {
+		TABLE = 0,
+		CSV,
+		JSON
+	};
+
+	//Collects measurements and prints them, the table puts every contender of a case side by side.
+	class Report final {
+	public:
+		inline void add(Measurement measurement) {
+			m_Measurements.push_back(std::move(measurement));
+		}
+
+		inline void write(std::ostream& stream, const ReportFormat format) const {
+			switch (format) {
+			case ReportFormat::CSV:
+				write_csv(stream);
+				break;
+			case ReportFormat::JSON:
+				write_json(stream);
+				break;
+			default:
+				write_table(stream);
+				break;
+			}
+		}
+
+		inline void write_csv(std::ostream& stream) const {
+			stream << "case,element,size,contender,ns_per_op,allocations,peak_bytes\n";
+			for (const Measurement& Current : m_Measurements) {
+				stream << Current.m_Case << ',' << Current.m_Element << ',' << Current.m_Size << ',' << Current.m_Contender << ','
+					<< Current.m_NanosecondsPerOperation << ',' << Current.m_Allocations << ',' << Current.m_PeakBytes << '\n';
+			}
+		}
+		inline void write_json(std::ostream& stream) const {
+			stream << "{\"benchmarks\":[";
+			for (size_type i = 0; i < m_Measurements.size(); i++) {
+				const Measurement& Current = m_Measurements[i];
+				stream << (i ? ",\n" : "\n") << "{\"case\":\"" << Current.m_Case << "\",\"element\":\"" << Current.m_Element
+					<< "\",\"size\":" << Current.m_Size << ",\"contender\":\"" << Current.m_Contender
+					<< "\",\"ns_per_op\":" << Current.m_NanosecondsPerOperation << ",\"allocations\":" << Current.m_Allocations
+					<< ",\"peak_bytes\":" << Current.m_PeakBytes << '}';
+			}
+			stream << "\n]}\n";
+		}
+		inline void write_table(std::ostream& stream) const {
+			std::vector<std::string> Contenders;
+			for (const Measurement& Current : m_Measurements) {
+				if (std::find(Contenders.begin(), Contenders.end(), Current.m_Contender) == Contenders.end())
+					Contenders.push_back(Current.m_Contender);
+			}
+
+			stream << std::left << std::setw(16) << "case" << std::setw(10) << "element" << std::right << std::setw(9) << "size";
+			for (const std::string& Contender : Contenders)
+				stream << " | " << std::setw(40) << Contender;
+			stream << '\n' << std::setw(35) << "";
+			for (size_type i = 0; i < Contenders.size(); i++)
+				stream << " | " << std::setw(12) << "ns/op" << std::setw(12) << "allocs" << std::setw(16) << "peak bytes";
+			stream << '\n';
+
+			for (size_type Row = 0; Row < m_Measurements.size();) {
+				const Measurement& First = m_Measurements[Row];
+				stream << std::left << std::setw(16) << First.m_Case << std::setw(10) << First.m_Element << std::right << std::setw(9) << First.m_Size;
+
+				size_type End = Row;
+				while (End < m_Measurements.size() && same_row(First, m_Measurements[End]))
+					End++;
+
+				for (const std::string& Contender : Contenders) {
+					const auto Found = std::find_if(m_Measurements.begin() + Row, m_Measurements.begin() + End,
+						[&Contender](const Measurement& candidate) { return candidate.m_Contender == Contender; });
+
+					stream << " | ";
+					if (Found == m_Measurements.begin() + End)
+						stream << std::setw(40) << "-";
+					else
+						stream << std::setw(12) << std::fixed << std::setprecision(2) << Found->m_NanosecondsPerOperation
+							<< std::setw(12) << Found->m_Allocations << std::setw(16) << Found->m_PeakBytes;
+				}
+				stream << '\n';
+				Row = End;
+			}
+		}
+
+		inline const std::vector<Measurement>& measurements() const noexcept { return m_Measurements; }
+
+	private:
+		static inline bool same_row(const Measurement& lhs, const Measurement& rhs) noexcept {
+			return lhs.m_Case == rhs.m_Case && lhs.m_Element == rhs.m_Element && lhs.m_Size == rhs.m_Size;
+		}
+
+	private:
+		std::vector<Measurement> m_Measurements;
+	};
+}
+
+#endif // !PROFILER_H
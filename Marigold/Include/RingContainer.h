@@ -0,0 +1,629 @@
+#include "Container.h"
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <compare>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+#ifndef RING_CONTAINER_H
+#define RING_CONTAINER_H
+
+
+namespace Marigold {
+
+	//What a full RingContainer does with one more element.
+	enum class RingOverflow {
+		GROW,		//Reallocates through the growth policy like Container.
+		OVERWRITE	//Keeps its capacity and replaces the element at the opposite end.
+	};
+
+	//Circular buffer over one block from Alloc, grown by the same Growth policies as Container. Pushing and popping
+	//at either end is O(1), the elements occupy at most two contiguous runs of the block. segments() exposes those
+	//runs and spare_segments() the free slots after the back, so bulk transfers and I/O need no intermediate copy.
+	//Iterators are invalidated by growth, and by any push or pop at the end they point past.
+	template<
+		class T,
+		class Alloc = CustomAllocator<T>,
+		class Growth = DoublingGrowth,
+		RingOverflow Overflow = RingOverflow::GROW
+	>
+	class RingContainer final {
+	public:
+		using Type = T;
+		using Allocator = Alloc;
+		using SizeType = std::size_t;
+		using Pointer = Type*;
+		using ConstantPointer = const T*;
+		using Reference = T&;
+		using ConstantReference = const T&;
+		using InitializerList = std::initializer_list<Type>;
+		using DifferenceType = std::ptrdiff_t;
+		using AllocatorTraits = std::allocator_traits<Allocator>;
+
+		using GrowthPolicy = Growth;
+
+		static constexpr RingOverflow OVERFLOW_MODE = Overflow;
+
+		static_assert(std::is_object_v<T>, "The C++ Standard forbids containers of non-object types "
+			"because of [container.requirements].");
+		static_assert(IsGrowthPolicy<Growth, Alloc>, "Growth has to provide next_capacity(capacity, required, elementSize, allocator).");
+
+	private:
+		template<bool IsConstant>
+		class BasicIterator {
+		public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = Type;
+			using difference_type = DifferenceType;
+			using pointer = std::conditional_t<IsConstant, ConstantPointer, Pointer>;
+			using reference = std::conditional_t<IsConstant, ConstantReference, Reference>;
+			using Owner = std::conditional_t<IsConstant, const RingContainer, RingContainer>;
+
+		public:
+			BasicIterator() noexcept = default;
+			BasicIterator(Owner* owner, const SizeType index) noexcept
+				: m_Owner(owner), m_Index(index)
+			{
+			}
+			template<bool OtherConstant> requires (IsConstant && !OtherConstant)
+			BasicIterator(const BasicIterator<OtherConstant>& other) noexcept
+				: m_Owner(other.m_Owner), m_Index(other.m_Index)
+			{
+			}
+
+			inline reference operator*() const noexcept { return (*m_Owner)[m_Index]; }
+			inline pointer operator->() const noexcept { return std::addressof((*m_Owner)[m_Index]); }
+			inline reference operator[](const difference_type offset) const noexcept { return *(*this + offset); }
+
+			inline BasicIterator& operator++() noexcept { ++m_Index; return *this; }
+			inline BasicIterator operator++(int) noexcept { BasicIterator Previous = *this; ++*this; return Previous; }
+			inline BasicIterator& operator--() noexcept { --m_Index; return *this; }
+			inline BasicIterator operator--(int) noexcept { BasicIterator Previous = *this; --*this; return Previous; }
+
+			inline BasicIterator& operator+=(const difference_type offset) noexcept { m_Index += offset; return *this; }
+			inline BasicIterator& operator-=(const difference_type offset) noexcept { m_Index -= offset; return *this; }
+
+			friend inline BasicIterator operator+(BasicIterator iterator, const difference_type offset) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator+(const difference_type offset, BasicIterator iterator) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator-(BasicIterator iterator, const difference_type offset) noexcept { return iterator -= offset; }
+			friend inline difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+				return static_cast<difference_type>(lhs.m_Index) - static_cast<difference_type>(rhs.m_Index);
+			}
+
+			inline bool operator==(const BasicIterator& other) const noexcept { return m_Index == other.m_Index; }
+			inline auto operator<=>(const BasicIterator& other) const noexcept { return m_Index <=> other.m_Index; }
+
+		private:
+			template<bool> friend class BasicIterator;
+
+			Owner* m_Owner = nullptr;
+			SizeType m_Index = 0;
+		};
+
+	public:
+		using Iterator = BasicIterator<false>;
+		using ConstantIterator = BasicIterator<true>;
+		using ReverseIterator = std::reverse_iterator<Iterator>;
+		using ReverseConstantIterator = std::reverse_iterator<ConstantIterator>;
+
+	public: //Special member functions
+		RingContainer() noexcept(noexcept(Allocator())) {}
+		explicit RingContainer(const Allocator& allocator) noexcept
+			: m_Allocator(allocator)
+		{
+		}
+		//Empty ring with room for capacity elements, the way to size an OVERWRITE ring.
+		explicit RingContainer(const SizeType capacity, const Allocator& allocator = Allocator())
+			: m_Allocator(allocator)
+		{
+			reserve(capacity);
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		RingContainer(InputIterator first, Sentinel last, const Allocator& allocator = Allocator())
+			: m_Allocator(allocator)
+		{
+			if constexpr (std::sized_sentinel_for<Sentinel, InputIterator>)
+				reserve(static_cast<SizeType>(last - first));
+			for (; first != last; ++first)
+				emplace_back(*first);
+		}
+		RingContainer(InitializerList list, const Allocator& allocator = Allocator())
+			: RingContainer(list.begin(), list.end(), allocator)
+		{
+		}
+
+		//Copy Semantics
+		RingContainer(const RingContainer& other)
+			: m_Allocator(AllocatorTraits::select_on_container_copy_construction(other.m_Allocator))
+		{
+			copy_from(other);
+		}
+		RingContainer& operator=(const RingContainer& other) {
+			if (this == &other)
+				return *this;
+
+			clear();
+			if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+				if (m_Allocator != other.m_Allocator) {
+					release();
+					m_Allocator = other.m_Allocator;
+				}
+			}
+
+			copy_from(other);
+			return *this;
+		}
+
+		//Move Semantics
+		RingContainer(RingContainer&& other) noexcept
+			: m_Allocator(std::move(other.m_Allocator))
+		{
+			steal(other);
+		}
+		RingContainer& operator=(RingContainer&& other) noexcept {
+			if (this == &other)
+				return *this;
+
+			clear();
+			if (AllocatorTraits::propagate_on_container_move_assignment::value || m_Allocator == other.m_Allocator) {
+				release();
+				if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value)
+					m_Allocator = std::move(other.m_Allocator);
+
+				steal(other);
+				return *this;
+			}
+
+			//Unequal allocators that do not propagate, the elements have to be moved one by one.
+			reserve(other.capacity());
+			for (Reference Element : other)
+				emplace_back(std::move(Element));
+			other.clear();
+			return *this;
+		}
+
+		~RingContainer() {
+			clear();
+			release();
+		}
+
+	public: //Access
+		inline Reference at(SizeType index) {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return (*this)[index];
+		}
+		inline ConstantReference at(SizeType index) const {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return (*this)[index];
+		}
+
+		inline Reference operator[](SizeType index) noexcept {
+			assert(index < size() && "Index out of range");
+			return *slot(index);
+		}
+		inline ConstantReference operator[](SizeType index) const noexcept {
+			assert(index < size() && "Index out of range");
+			return *slot(index);
+		}
+
+		inline Reference front() noexcept { return (*this)[0]; }
+		inline ConstantReference front() const noexcept { return (*this)[0]; }
+		inline Reference back() noexcept { return (*this)[m_Size - 1]; }
+		inline ConstantReference back() const noexcept { return (*this)[m_Size - 1]; }
+
+		//The elements in order as up to two contiguous runs, the second is empty unless the ring wraps.
+		inline std::array<std::span<Type>, 2> segments() noexcept {
+			const SizeType First = m_Capacity - m_Head < m_Size ? m_Capacity - m_Head : m_Size;
+			return { std::span<Type>(m_Data + m_Head, First), std::span<Type>(m_Data, m_Size - First) };
+		}
+		inline std::array<std::span<const Type>, 2> segments() const noexcept {
+			const SizeType First = m_Capacity - m_Head < m_Size ? m_Capacity - m_Head : m_Size;
+			return { std::span<const Type>(m_Data + m_Head, First), std::span<const Type>(m_Data, m_Size - First) };
+		}
+
+		//The free slots after the back as up to two contiguous runs. They hold no objects, fill a prefix of them and
+		//publish it with commit_back, e.g. to read from a socket straight into the ring.
+		inline std::array<std::span<Type>, 2> spare_segments() noexcept requires std::is_trivially_copyable_v<Type> {
+			const SizeType Free = m_Capacity - m_Size;
+			const SizeType Tail = wrap(m_Head + m_Size);
+			const SizeType First = m_Capacity - Tail < Free ? m_Capacity - Tail : Free;
+			return { std::span<Type>(m_Data + Tail, First), std::span<Type>(m_Data, Free - First) };
+		}
+		inline void commit_back(const SizeType count) noexcept requires std::is_trivially_copyable_v<Type> {
+			assert(count <= m_Capacity - m_Size && "Committed more than the spare capacity");
+			m_Size += count;
+		}
+
+	public: //Insertion
+		inline void push_back(ConstantReference value) { emplace_back(value); }
+		inline void push_back(Type&& value) { emplace_back(std::move(value)); }
+		inline void push_front(ConstantReference value) { emplace_front(value); }
+		inline void push_front(Type&& value) { emplace_front(std::move(value)); }
+
+		template<class... args>
+		Reference emplace_back(args&&... arguments) {
+			if (m_Size == m_Capacity) {
+				if constexpr (Overflow == RingOverflow::OVERWRITE) {
+					//The oldest element makes room, the slot it leaves is the new back.
+					//The value is built first since the arguments may refer to the element being dropped.
+					require_capacity();
+					Type Value(std::forward<args>(arguments)...);
+					pop_front();
+					Pointer Slot = m_Data + wrap(m_Head + m_Size);
+					AllocatorTraits::construct(m_Allocator, Slot, std::move(Value));
+					m_Size++;
+					return *Slot;
+				}
+				else {
+					//The new element goes behind the old ones in the new block.
+					grow(m_Size, 0, std::forward<args>(arguments)...);
+					return m_Data[m_Size - 1];
+				}
+			}
+
+			Pointer Slot = m_Data + wrap(m_Head + m_Size);
+			AllocatorTraits::construct(m_Allocator, Slot, std::forward<args>(arguments)...);
+			m_Size++;
+			return *Slot;
+		}
+		template<class... args>
+		Reference emplace_front(args&&... arguments) {
+			if (m_Size == m_Capacity) {
+				if constexpr (Overflow == RingOverflow::OVERWRITE) {
+					require_capacity();
+					Type Value(std::forward<args>(arguments)...);
+					pop_back();
+					const SizeType Head = m_Head == 0 ? m_Capacity - 1 : m_Head - 1;
+					AllocatorTraits::construct(m_Allocator, m_Data + Head, std::move(Value));
+					m_Head = Head;
+					m_Size++;
+					return m_Data[Head];
+				}
+				else {
+					//The new element takes slot 0 and the old ones follow it.
+					grow(0, 1, std::forward<args>(arguments)...);
+					return m_Data[0];
+				}
+			}
+
+			const SizeType Head = m_Head == 0 ? m_Capacity - 1 : m_Head - 1;
+			AllocatorTraits::construct(m_Allocator, m_Data + Head, std::forward<args>(arguments)...);
+			m_Head = Head;
+			m_Size++;
+			return m_Data[Head];
+		}
+
+		//Copies values behind the back, at most two contiguous copies for trivially copyable types.
+		//An OVERWRITE ring keeps the newest capacity() elements.
+		void enqueue(std::span<const Type> values) {
+			if (overlaps(values)) {
+				//Growing frees the block and overwriting drops the front, values that live in this ring are copied out first.
+				RingContainer Staged(values.size(), m_Allocator);
+				Staged.enqueue(values);
+				enqueue(Staged.segments()[0]);
+				return;
+			}
+
+			if constexpr (Overflow == RingOverflow::OVERWRITE) {
+				if (values.size() > m_Capacity)
+					values = values.last(m_Capacity);
+				const SizeType Free = m_Capacity - m_Size;
+				if (values.size() > Free)
+					pop_front(values.size() - Free);
+			}
+			else if (values.size() > m_Capacity - m_Size)
+				reserve(grow_capacity(m_Size + values.size()));
+
+			if constexpr (std::is_trivially_copyable_v<Type>) {
+				const std::array<std::span<Type>, 2> Spare = spare_segments();
+				const SizeType First = Spare[0].size() < values.size() ? Spare[0].size() : values.size();
+				copy_elements(Spare[0].data(), values.data(), First);
+				copy_elements(Spare[1].data(), values.data() + First, values.size() - First);
+				m_Size += values.size();
+			}
+			else {
+				for (ConstantReference Value : values)
+					emplace_back(Value);
+			}
+		}
+		template<std::ranges::input_range Range>
+		inline void append_range(Range&& range) {
+			if constexpr (std::ranges::contiguous_range<Range> && std::is_same_v<std::ranges::range_value_t<Range>, Type>)
+				enqueue(std::span<const Type>(std::ranges::data(range), std::ranges::size(range)));
+			else {
+				for (auto&& Value : range)
+					emplace_back(std::forward<decltype(Value)>(Value));
+			}
+		}
+
+	public: //Removal
+		inline void pop_front() noexcept {
+			if (m_Size == 0)
+				return;
+
+			AllocatorTraits::destroy(m_Allocator, m_Data + m_Head);
+			m_Head = wrap(m_Head + 1);
+			if (--m_Size == 0)
+				m_Head = 0;
+		}
+		inline void pop_back() noexcept {
+			if (m_Size == 0)
+				return;
+
+			AllocatorTraits::destroy(m_Allocator, slot(m_Size - 1));
+			if (--m_Size == 0)
+				m_Head = 0;
+		}
+		//Drops the count oldest elements, the usual follow up to reading segments().
+		void pop_front(SizeType count) noexcept {
+			count = count < m_Size ? count : m_Size;
+			if constexpr (!std::is_trivially_destructible_v<Type>) {
+				for (SizeType i = 0; i < count; i++)
+					AllocatorTraits::destroy(m_Allocator, slot(i));
+			}
+
+			m_Head = wrap(m_Head + count);
+			m_Size -= count;
+			if (m_Size == 0)
+				m_Head = 0;
+		}
+		//Moves up to out.size() of the oldest elements into out and removes them, returns how many.
+		SizeType dequeue(std::span<Type> out) {
+			const SizeType Count = out.size() < m_Size ? out.size() : m_Size;
+			if constexpr (std::is_trivially_copyable_v<Type>) {
+				const std::array<std::span<Type>, 2> Stored = segments();
+				const SizeType First = Stored[0].size() < Count ? Stored[0].size() : Count;
+				copy_elements(out.data(), Stored[0].data(), First);
+				copy_elements(out.data() + First, Stored[1].data(), Count - First);
+			}
+			else {
+				for (SizeType i = 0; i < Count; i++)
+					out[i] = std::move(*slot(i));
+			}
+
+			pop_front(Count);
+			return Count;
+		}
+		inline void clear() noexcept {
+			pop_front(m_Size);
+		}
+
+	public: //Iterators
+		inline Iterator begin() noexcept { return Iterator(this, 0); }
+		inline ConstantIterator begin() const noexcept { return ConstantIterator(this, 0); }
+		inline ConstantIterator cbegin() const noexcept { return begin(); }
+
+		inline Iterator end() noexcept { return Iterator(this, m_Size); }
+		inline ConstantIterator end() const noexcept { return ConstantIterator(this, m_Size); }
+		inline ConstantIterator cend() const noexcept { return end(); }
+
+		inline ReverseIterator rbegin() noexcept { return ReverseIterator(end()); }
+		inline ReverseConstantIterator rbegin() const noexcept { return ReverseConstantIterator(end()); }
+		inline ReverseConstantIterator crbegin() const noexcept { return rbegin(); }
+
+		inline ReverseIterator rend() noexcept { return ReverseIterator(begin()); }
+		inline ReverseConstantIterator rend() const noexcept { return ReverseConstantIterator(begin()); }
+		inline ReverseConstantIterator crend() const noexcept { return rend(); }
+
+	public: //Capacity
+		void reserve(SizeType capacity) {
+			if (capacity <= m_Capacity)
+				return;
+			if (capacity > max_size())
+				throw std::length_error("Max allowed container size exceeded!");
+
+			reallocate(capacity);
+		}
+		inline void shrink_to_fit() {
+			if (m_Size == m_Capacity)
+				return;
+			if (m_Size == 0) {
+				release();
+				return;
+			}
+
+			reallocate(m_Size);
+		}
+		inline void swap(RingContainer& other) noexcept {
+			if (this == &other)
+				return;
+
+			if constexpr (AllocatorTraits::propagate_on_container_swap::value || AllocatorTraits::is_always_equal::value)
+				std::swap(m_Allocator, other.m_Allocator);
+
+			std::swap(m_Data, other.m_Data);
+			std::swap(m_Capacity, other.m_Capacity);
+			std::swap(m_Head, other.m_Head);
+			std::swap(m_Size, other.m_Size);
+		}
+
+		inline Allocator get_allocator() const noexcept { return m_Allocator; }
+		constexpr inline SizeType max_size() const noexcept { return std::numeric_limits<SizeType>::max() / sizeof(Type); }
+		inline SizeType capacity() const noexcept { return m_Capacity; }
+		inline SizeType size() const noexcept { return m_Size; }
+		inline bool empty() const noexcept { return m_Size == 0; }
+		inline bool full() const noexcept { return m_Size == m_Capacity; }
+
+	private:
+		inline SizeType wrap(const SizeType index) const noexcept {
+			//Indices never reach twice the capacity, one subtraction is enough.
+			return index >= m_Capacity ? index - m_Capacity : index;
+		}
+		inline Pointer slot(const SizeType index) const noexcept {
+			return m_Data + wrap(m_Head + index);
+		}
+
+		inline bool overlaps(const std::span<const Type> values) const noexcept {
+			if (values.empty() || !m_Data)
+				return false;
+
+			const std::less<ConstantPointer> Less;
+			return Less(values.data(), m_Data + m_Capacity) && Less(m_Data, values.data() + values.size());
+		}
+		inline void require_capacity() const {
+			if (m_Capacity == 0)
+				throw std::length_error("An overwriting ring needs a capacity, construct it with one or call reserve");
+		}
+		inline SizeType grow_capacity(const SizeType required) const noexcept {
+			const SizeType Grown = Growth::next_capacity(m_Capacity, required, sizeof(Type), m_Allocator);
+			if (Grown < required)
+				return required;
+
+			return Grown > max_size() && required <= max_size() ? max_size() : Grown;
+		}
+
+		static inline void copy_elements(Pointer destination, ConstantPointer source, const SizeType count) noexcept {
+			if (count)
+				std::memcpy(static_cast<void*>(destination), static_cast<const void*>(source), count * sizeof(Type));
+		}
+
+		inline Pointer allocate_block(const SizeType capacity) {
+			Pointer Block = AllocatorTraits::allocate(m_Allocator, allocation_size<Allocator>(sizeof(Type) * capacity));
+			if (!Block)
+				throw std::bad_alloc();
+
+			return Block;
+		}
+		inline void deallocate_block(Pointer block, const SizeType capacity) noexcept {
+			if (block)
+				AllocatorTraits::deallocate(m_Allocator, block, allocation_size<Allocator>(sizeof(Type) * capacity));
+		}
+
+		void reallocate(const SizeType capacity) {
+			Pointer NewBlock = allocate_block(capacity);
+			try {
+				transfer(NewBlock);
+			}
+			catch (...) {
+				deallocate_block(NewBlock, capacity);
+				throw;
+			}
+
+			adopt(NewBlock, capacity);
+		}
+		template<class... args>
+		void grow(const SizeType at, const SizeType offset, args&&... arguments) {
+			//The new element is built in the new block before anything moves, the arguments may refer to an element of this ring.
+			const SizeType Capacity = grow_capacity(m_Size + 1);
+			if (Capacity > max_size())
+				throw std::length_error("Max allowed container size exceeded!");
+
+			Pointer NewBlock = allocate_block(Capacity);
+			try {
+				AllocatorTraits::construct(m_Allocator, NewBlock + at, std::forward<args>(arguments)...);
+			}
+			catch (...) {
+				deallocate_block(NewBlock, Capacity);
+				throw;
+			}
+
+			try {
+				transfer(NewBlock + offset);
+			}
+			catch (...) {
+				AllocatorTraits::destroy(m_Allocator, NewBlock + at);
+				deallocate_block(NewBlock, Capacity);
+				throw;
+			}
+
+			adopt(NewBlock, Capacity);
+			m_Size++;
+		}
+		void transfer(Pointer destination) {
+			//Straightens the ring into destination, the front lands first. Every element is built before any original
+			//is destroyed, if one throws the copies made so far are undone and the ring is left as it was.
+			const SizeType First = m_Capacity - m_Head < m_Size ? m_Capacity - m_Head : m_Size;
+			if constexpr (IsTriviallyRelocatable<Type>::value) {
+				copy_elements(destination, m_Data + m_Head, First);
+				copy_elements(destination + First, m_Data, m_Size - First);
+			}
+			else {
+				SizeType Built = 0;
+				try {
+					for (; Built < m_Size; Built++)
+						AllocatorTraits::construct(m_Allocator, destination + Built, std::move_if_noexcept(*slot(Built)));
+				}
+				catch (...) {
+					for (SizeType i = 0; i < Built; i++)
+						AllocatorTraits::destroy(m_Allocator, destination + i);
+					throw;
+				}
+
+				for (SizeType i = 0; i < m_Size; i++)
+					AllocatorTraits::destroy(m_Allocator, slot(i));
+			}
+		}
+		inline void adopt(Pointer block, const SizeType capacity) noexcept {
+			//Expects the elements to have been transferred to block already.
+			deallocate_block(m_Data, m_Capacity);
+			m_Data = block;
+			m_Capacity = capacity;
+			m_Head = 0;
+		}
+		inline void release() noexcept {
+			//Expects the ring to be empty.
+			if (m_Data)
+				AllocatorTraits::deallocate(m_Allocator, m_Data, allocation_size<Allocator>(sizeof(Type) * m_Capacity));
+
+			m_Data = nullptr;
+			m_Capacity = 0;
+			m_Head = 0;
+		}
+		inline void steal(RingContainer& other) noexcept {
+			m_Data = std::exchange(other.m_Data, nullptr);
+			m_Capacity = std::exchange(other.m_Capacity, 0);
+			m_Head = std::exchange(other.m_Head, 0);
+			m_Size = std::exchange(other.m_Size, 0);
+		}
+		inline void copy_from(const RingContainer& other) {
+			reserve(other.m_Capacity);
+			for (const std::span<const Type> Segment : other.segments()) {
+				for (ConstantReference Value : Segment)
+					emplace_back(Value);
+			}
+		}
+
+	private:
+		Pointer m_Data = nullptr;
+		SizeType m_Capacity = 0;
+		SizeType m_Head = 0;
+		SizeType m_Size = 0;
+		Allocator m_Allocator;
+	};
+
+	//Fixed capacity ring that overwrites its oldest entries once full, for telemetry and log tails.
+	template<class T, class Alloc = CustomAllocator<T>>
+	using RingLog = RingContainer<T, Alloc, DoublingGrowth, RingOverflow::OVERWRITE>;
+
+
+	//Non-member functions
+	template<class Type, class Allocator, class Growth, RingOverflow Overflow>
+	inline void swap(RingContainer<Type, Allocator, Growth, Overflow>& lhs, RingContainer<Type, Allocator, Growth, Overflow>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+
+	//Operators
+	template<class Type, class Allocator, class Growth, RingOverflow Overflow>
+	bool operator==(const RingContainer<Type, Allocator, Growth, Overflow>& lhs, const RingContainer<Type, Allocator, Growth, Overflow>& rhs) {
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+}
+
+#endif // !RING_CONTAINER_H
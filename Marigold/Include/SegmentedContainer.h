@@ -0,0 +1,478 @@
+#include "Container.h"
+#include <cstddef>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+#ifndef SEGMENTED_CONTAINER_H
+#define SEGMENTED_CONTAINER_H
+
+
+namespace Marigold {
+
+	inline constexpr std::size_t SEGMENT_BYTES = 4096;
+
+	//Elements per segment so a segment fills about SEGMENT_BYTES, rounded down to a power of two.
+	template<class T>
+	inline constexpr std::size_t DEFAULT_SEGMENT_SIZE = std::bit_floor(SEGMENT_BYTES / sizeof(T) > 16 ? SEGMENT_BYTES / sizeof(T) : std::size_t(16));
+
+	//Sequence of fixed size segments indexed through a directory of segment pointers. Elements never move once
+	//constructed, so pointers and references stay valid across growth, and appending never copies existing elements.
+	//Indexing is a shift and a mask into the directory, iteration walks each segment contiguously.
+	//Iterators are invalidated when a segment is added, like those of std::deque.
+	template<
+		class T,
+		class Alloc = CustomAllocator<T>,
+		std::size_t SegmentSize = DEFAULT_SEGMENT_SIZE<T>
+	>
+	class SegmentedContainer final {
+	public:
+		using Type = T;
+		using Allocator = Alloc;
+		using SizeType = std::size_t;
+		using Pointer = Type*;
+		using ConstantPointer = const T*;
+		using Reference = T&;
+		using ConstantReference = const T&;
+		using InitializerList = std::initializer_list<Type>;
+		using DifferenceType = std::ptrdiff_t;
+		using AllocatorTraits = std::allocator_traits<Allocator>;
+		using DirectoryAllocator = typename AllocatorTraits::template rebind_alloc<Pointer>;
+
+		static constexpr SizeType SEGMENT_SIZE = SegmentSize;
+
+		static_assert(std::is_object_v<T>, "The C++ Standard forbids containers of non-object types "
+			"because of [container.requirements].");
+		static_assert(SegmentSize > 0 && (SegmentSize & (SegmentSize - 1)) == 0, "SegmentSize has to be a power of two.");
+
+	private:
+		static constexpr SizeType SEGMENT_SHIFT = std::countr_zero(SegmentSize);
+		static constexpr SizeType SEGMENT_MASK = SegmentSize - 1;
+
+		//The directory always ends in a null entry, so iterators stepping off the last segment have somewhere to land.
+		using Directory = Container<Pointer, DirectoryAllocator>;
+
+		template<bool IsConstant>
+		class BasicIterator {
+		public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = Type;
+			using difference_type = DifferenceType;
+			using pointer = std::conditional_t<IsConstant, ConstantPointer, Pointer>;
+			using reference = std::conditional_t<IsConstant, ConstantReference, Reference>;
+
+		public:
+			BasicIterator() noexcept = default;
+			BasicIterator(const Pointer* segment, const Pointer current) noexcept
+				: m_Segment(segment), m_Current(current)
+			{
+			}
+			template<bool OtherConstant> requires (IsConstant && !OtherConstant)
+			BasicIterator(const BasicIterator<OtherConstant>& other) noexcept
+				: m_Segment(other.m_Segment), m_Current(other.m_Current)
+			{
+			}
+
+			inline reference operator*() const noexcept { return *m_Current; }
+			inline pointer operator->() const noexcept { return m_Current; }
+			inline reference operator[](const difference_type offset) const noexcept { return *(*this + offset); }
+
+			inline BasicIterator& operator++() noexcept {
+				if (++m_Current == *m_Segment + SegmentSize)
+					m_Current = *++m_Segment;
+				return *this;
+			}
+			inline BasicIterator operator++(int) noexcept {
+				BasicIterator Previous = *this;
+				++*this;
+				return Previous;
+			}
+			inline BasicIterator& operator--() noexcept {
+				if (m_Current == *m_Segment)
+					m_Current = *--m_Segment + SegmentSize;
+				--m_Current;
+				return *this;
+			}
+			inline BasicIterator operator--(int) noexcept {
+				BasicIterator Previous = *this;
+				--*this;
+				return Previous;
+			}
+
+			inline BasicIterator& operator+=(const difference_type offset) noexcept {
+				//Begin and end of a container without a directory are both null, the only valid offset is 0.
+				if (!m_Segment)
+					return *this;
+
+				const difference_type Position = (m_Current - *m_Segment) + offset;
+				const difference_type Segments = Position >= 0 ? Position >> SEGMENT_SHIFT : -((-Position - 1) >> SEGMENT_SHIFT) - 1;
+				m_Segment += Segments;
+				m_Current = *m_Segment + (Position - Segments * static_cast<difference_type>(SegmentSize));
+				return *this;
+			}
+			inline BasicIterator& operator-=(const difference_type offset) noexcept { return *this += -offset; }
+
+			friend inline BasicIterator operator+(BasicIterator iterator, const difference_type offset) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator+(const difference_type offset, BasicIterator iterator) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator-(BasicIterator iterator, const difference_type offset) noexcept { return iterator -= offset; }
+			friend inline difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+				if (!lhs.m_Segment || !rhs.m_Segment)
+					return 0;
+
+				return (lhs.m_Segment - rhs.m_Segment) * static_cast<difference_type>(SegmentSize)
+					+ (lhs.m_Current - *lhs.m_Segment) - (rhs.m_Current - *rhs.m_Segment);
+			}
+
+			inline bool operator==(const BasicIterator& other) const noexcept { return m_Current == other.m_Current && m_Segment == other.m_Segment; }
+			inline std::strong_ordering operator<=>(const BasicIterator& other) const noexcept {
+				if (m_Segment != other.m_Segment)
+					return m_Segment <=> other.m_Segment;
+				if (!m_Segment)
+					return std::strong_ordering::equal;
+
+				return (m_Current - *m_Segment) <=> (other.m_Current - *other.m_Segment);
+			}
+
+		private:
+			template<bool> friend class BasicIterator;
+
+			const Pointer* m_Segment = nullptr;
+			Pointer m_Current = nullptr;
+		};
+
+	public:
+		using Iterator = BasicIterator<false>;
+		using ConstantIterator = BasicIterator<true>;
+		using ReverseIterator = std::reverse_iterator<Iterator>;
+		using ReverseConstantIterator = std::reverse_iterator<ConstantIterator>;
+
+	public: //Special member functions
+		SegmentedContainer() noexcept(noexcept(Allocator())) {}
+		explicit SegmentedContainer(const Allocator& allocator) noexcept
+			: m_Directory(DirectoryAllocator(allocator)), m_Allocator(allocator)
+		{
+		}
+		SegmentedContainer(const SizeType count, ConstantReference value, const Allocator& allocator = Allocator())
+			: SegmentedContainer(allocator)
+		{
+			resize(count, value);
+		}
+		explicit SegmentedContainer(const SizeType count, const Allocator& allocator = Allocator())
+			: SegmentedContainer(allocator)
+		{
+			resize(count);
+		}
+		template<std::input_iterator InputIterator, std::sentinel_for<InputIterator> Sentinel>
+		SegmentedContainer(InputIterator first, Sentinel last, const Allocator& allocator = Allocator())
+			: SegmentedContainer(allocator)
+		{
+			for (; first != last; ++first)
+				emplace_back(*first);
+		}
+		SegmentedContainer(InitializerList list, const Allocator& allocator = Allocator())
+			: SegmentedContainer(list.begin(), list.end(), allocator)
+		{
+		}
+
+		//Copy Semantics
+		SegmentedContainer(const SegmentedContainer& other)
+			: SegmentedContainer(AllocatorTraits::select_on_container_copy_construction(other.m_Allocator))
+		{
+			copy_from(other);
+		}
+		SegmentedContainer& operator=(const SegmentedContainer& other) {
+			if (this == &other)
+				return *this;
+
+			clear();
+			if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+				if (m_Allocator != other.m_Allocator) {
+					release_segments();
+					m_Allocator = other.m_Allocator;
+					//The directory holds no memory after release_segments, it is rebuilt on the new allocator
+					//since its own assignments only take an allocator along when the traits allow it.
+					std::destroy_at(&m_Directory);
+					std::construct_at(&m_Directory, DirectoryAllocator(m_Allocator));
+				}
+			}
+
+			copy_from(other);
+			return *this;
+		}
+
+		//Move Semantics
+		SegmentedContainer(SegmentedContainer&& other) noexcept
+			: m_Directory(std::move(other.m_Directory)), m_Size(other.m_Size), m_Allocator(std::move(other.m_Allocator))
+		{
+			other.m_Size = 0;
+		}
+		SegmentedContainer& operator=(SegmentedContainer&& other) noexcept {
+			if (this == &other)
+				return *this;
+
+			clear();
+			if (AllocatorTraits::propagate_on_container_move_assignment::value || m_Allocator == other.m_Allocator) {
+				release_segments();
+				if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value)
+					m_Allocator = std::move(other.m_Allocator);
+
+				m_Directory = std::move(other.m_Directory);
+				m_Size = other.m_Size;
+				other.m_Size = 0;
+				return *this;
+			}
+
+			//Unequal allocators that do not propagate, the elements have to be moved one by one.
+			reserve(other.size());
+			for (Reference Element : other)
+				emplace_back(std::move(Element));
+			other.clear();
+			return *this;
+		}
+
+		~SegmentedContainer() {
+			clear();
+			release_segments();
+		}
+
+	public: //Access
+		inline Reference at(SizeType index) {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return (*this)[index];
+		}
+		inline ConstantReference at(SizeType index) const {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return (*this)[index];
+		}
+
+		inline Reference operator[](SizeType index) noexcept {
+			assert(index < size() && "Index out of range");
+			return m_Directory[index >> SEGMENT_SHIFT][index & SEGMENT_MASK];
+		}
+		inline ConstantReference operator[](SizeType index) const noexcept {
+			assert(index < size() && "Index out of range");
+			return m_Directory[index >> SEGMENT_SHIFT][index & SEGMENT_MASK];
+		}
+
+		inline Reference front() noexcept { return (*this)[0]; }
+		inline ConstantReference front() const noexcept { return (*this)[0]; }
+
+		inline Reference back() noexcept { return (*this)[m_Size - 1]; }
+		inline ConstantReference back() const noexcept { return (*this)[m_Size - 1]; }
+
+		//Calls function(segment, count) for every run of contiguous elements, in order.
+		//The fastest way to visit everything, the inner loop is a plain pointer walk.
+		template<class Function>
+		inline void for_each_segment(Function function) {
+			for (SizeType Index = 0; Index < m_Size; Index += SegmentSize)
+				function(m_Directory[Index >> SEGMENT_SHIFT], m_Size - Index < SegmentSize ? m_Size - Index : SegmentSize);
+		}
+		template<class Function>
+		inline void for_each_segment(Function function) const {
+			for (SizeType Index = 0; Index < m_Size; Index += SegmentSize)
+				function(static_cast<ConstantPointer>(m_Directory[Index >> SEGMENT_SHIFT]), m_Size - Index < SegmentSize ? m_Size - Index : SegmentSize);
+		}
+
+	public: //Insertion
+		inline void push_back(ConstantReference value) {
+			emplace_back(value);
+		}
+		inline void push_back(Type&& value) {
+			emplace_back(std::move(value));
+		}
+
+		template<class... args>
+		inline Reference emplace_back(args&&... arguments) {
+			if (m_Size == capacity())
+				add_segment();
+
+			Pointer Slot = m_Directory[m_Size >> SEGMENT_SHIFT] + (m_Size & SEGMENT_MASK);
+			AllocatorTraits::construct(m_Allocator, Slot, std::forward<args>(arguments)...);
+			m_Size++;
+			return *Slot;
+		}
+
+	public: //Removal
+		inline void clear() noexcept {
+			shrink_size(0);
+		}
+		inline void pop_back() {
+			if (m_Size == 0)
+				return;
+
+			shrink_size(m_Size - 1);
+		}
+
+	public: //Iterators
+		inline Iterator begin() noexcept { return make_iterator<Iterator>(0); }
+		inline ConstantIterator begin() const noexcept { return make_iterator<ConstantIterator>(0); }
+		inline ConstantIterator cbegin() const noexcept { return begin(); }
+
+		inline ReverseIterator rbegin() noexcept { return ReverseIterator(end()); }
+		inline ReverseConstantIterator rbegin() const noexcept { return ReverseConstantIterator(end()); }
+		inline ReverseConstantIterator crbegin() const noexcept { return rbegin(); }
+
+		inline ReverseIterator rend() noexcept { return ReverseIterator(begin()); }
+		inline ReverseConstantIterator rend() const noexcept { return ReverseConstantIterator(begin()); }
+		inline ReverseConstantIterator crend() const noexcept { return rend(); }
+
+		inline Iterator end() noexcept { return make_iterator<Iterator>(m_Size); }
+		inline ConstantIterator end() const noexcept { return make_iterator<ConstantIterator>(m_Size); }
+		inline ConstantIterator cend() const noexcept { return end(); }
+
+	public: //Capacity
+		inline void reserve(SizeType capacity) {
+			if (capacity > max_size())
+				throw std::length_error("Max allowed container size exceeded!");
+
+			while (this->capacity() < capacity)
+				add_segment();
+		}
+		inline void shrink_to_fit() {
+			//Returns the segments past the last element, the directory itself is trimmed as well.
+			const SizeType Needed = (m_Size + SegmentSize - 1) >> SEGMENT_SHIFT;
+			while (segment_count() > Needed) {
+				const SizeType Last = segment_count() - 1;
+				AllocatorTraits::deallocate(m_Allocator, m_Directory[Last], allocation_size<Allocator>(sizeof(Type) * SegmentSize));
+				m_Directory.pop_back();
+				m_Directory[Last] = nullptr;
+			}
+
+			m_Directory.shrink_to_fit();
+		}
+		inline void swap(SegmentedContainer& other) noexcept {
+			if (this == &other)
+				return;
+
+			if constexpr (AllocatorTraits::propagate_on_container_swap::value || AllocatorTraits::is_always_equal::value)
+				std::swap(m_Allocator, other.m_Allocator);
+
+			m_Directory.swap(other.m_Directory);
+			std::swap(m_Size, other.m_Size);
+		}
+
+		void resize(SizeType count) {
+			if (count <= size()) {
+				shrink_size(count);
+				return;
+			}
+
+			reserve(count);
+			while (m_Size < count)
+				emplace_back();
+		}
+		void resize(SizeType count, ConstantReference value) {
+			if (count <= size()) {
+				shrink_size(count);
+				return;
+			}
+
+			reserve(count); //Segments never move, value stays valid even if it is one of the elements.
+			while (m_Size < count)
+				emplace_back(value);
+		}
+
+		inline Allocator get_allocator() const noexcept { return m_Allocator; }
+		constexpr inline SizeType max_size() const noexcept { return std::numeric_limits<SizeType>::max() / sizeof(Type); }
+		inline SizeType capacity() const noexcept { return segment_count() << SEGMENT_SHIFT; }
+		inline SizeType size() const noexcept { return m_Size; }
+		inline bool empty() const noexcept { return m_Size == 0; }
+		inline SizeType segment_count() const noexcept { return m_Directory.empty() ? 0 : m_Directory.size() - 1; }
+
+	private:
+		template<class IteratorType>
+		inline IteratorType make_iterator(const SizeType index) const noexcept {
+			if (m_Directory.empty())
+				return IteratorType();
+
+			const Pointer* Segment = m_Directory.data() + (index >> SEGMENT_SHIFT);
+			return IteratorType(Segment, *Segment + (index & SEGMENT_MASK));
+		}
+
+		inline void add_segment() {
+			if (m_Directory.empty())
+				m_Directory.push_back(nullptr);
+
+			//Make room for the new null entry first, so a failure leaves the directory untouched.
+			m_Directory.reserve(m_Directory.size() + 1);
+			Pointer Segment = AllocatorTraits::allocate(m_Allocator, allocation_size<Allocator>(sizeof(Type) * SegmentSize));
+			if (!Segment)
+				throw std::bad_alloc();
+
+			m_Directory.back() = Segment;
+			m_Directory.push_back(nullptr);
+		}
+		inline void release_segments() noexcept {
+			for (SizeType i = 0; i < segment_count(); i++)
+				AllocatorTraits::deallocate(m_Allocator, m_Directory[i], allocation_size<Allocator>(sizeof(Type) * SegmentSize));
+
+			m_Directory.clear();
+			m_Directory.shrink_to_fit();
+		}
+		inline void shrink_size(const SizeType count) noexcept {
+			if constexpr (!std::is_trivially_destructible_v<Type>) {
+				for (SizeType i = m_Size; i > count; i--)
+					AllocatorTraits::destroy(m_Allocator, std::addressof((*this)[i - 1]));
+			}
+
+			m_Size = count;
+		}
+		inline void copy_from(const SegmentedContainer& other) {
+			reserve(other.size());
+			other.for_each_segment([this](ConstantPointer segment, const SizeType count) {
+				for (SizeType i = 0; i < count; i++)
+					emplace_back(segment[i]);
+			});
+		}
+
+	private:
+		Directory m_Directory;
+		SizeType m_Size = 0;
+		Allocator m_Allocator;
+	};
+
+
+	//Non-member functions
+	template<class Type, class Allocator, std::size_t SegmentSize>
+	inline void swap(SegmentedContainer<Type, Allocator, SegmentSize>& lhs, SegmentedContainer<Type, Allocator, SegmentSize>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+	template<class Type, class Allocator, std::size_t SegmentSize, class Predicate>
+	SegmentedContainer<Type, Allocator, SegmentSize>::SizeType erase_if(SegmentedContainer<Type, Allocator, SegmentSize>& container, Predicate predicate) {
+		//Survivors are compacted towards the front, only the tail is destroyed.
+		const auto Kept = std::remove_if(container.begin(), container.end(), predicate);
+		const auto Removed = static_cast<std::size_t>(container.end() - Kept);
+		for (std::size_t i = 0; i < Removed; i++)
+			container.pop_back();
+		return Removed;
+	}
+
+
+	//Operators
+	template<class Type, class Allocator, std::size_t SegmentSize>
+	bool operator==(const SegmentedContainer<Type, Allocator, SegmentSize>& lhs, const SegmentedContainer<Type, Allocator, SegmentSize>& rhs) {
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template<class Type, class Allocator, std::size_t SegmentSize>
+	std::_Synth_three_way_result<Type> operator<=>(const SegmentedContainer<Type, Allocator, SegmentSize>& lhs, const SegmentedContainer<Type, Allocator, SegmentSize>& rhs) {
+		return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::_Synth_three_way());
+	}
+}
+
+#endif // !SEGMENTED_CONTAINER_H
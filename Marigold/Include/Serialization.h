@@ -0,0 +1,550 @@
+#include "Container.h"
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <concepts>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+
+namespace Marigold {
+
+	inline constexpr std::uint64_t SERIALIZED_MAGIC = 0x315253444C47524Dull; //"MRGLDSR1" in little endian
+	inline constexpr std::uint32_t SERIALIZED_FORMAT_VERSION = 1;
+	inline constexpr std::uint32_t SERIALIZED_BYTE_ORDER = 0x01020304u;
+	inline constexpr std::uint16_t SERIALIZED_FLAG_CHECKSUM = 1;
+	//Elements that are not trivially copyable are encoded into chunks of about this many bytes.
+	inline constexpr std::size_t SERIALIZED_CHUNK_SIZE = 64 * 1024;
+
+	//RAW stores the elements as one block of bytes, CHUNKED frames encoded elements as
+	//{ bytes, count, payload } chunks closed by an empty chunk.
+	enum class SerializedEncoding : std::uint16_t {
+		RAW = 0,
+		CHUNKED
+	};
+
+	//Leads every serialized container. RAW elements start at the header size rounded up to their alignment,
+	//so a suitably aligned buffer can be read in place. With SERIALIZED_FLAG_CHECKSUM a Checksum of every byte
+	//between header and checksum trails the payload.
+	struct SerializedHeader {
+		std::uint64_t m_Magic = SERIALIZED_MAGIC;
+		std::uint32_t m_FormatVersion = SERIALIZED_FORMAT_VERSION;
+		std::uint32_t m_ByteOrder = SERIALIZED_BYTE_ORDER;
+		std::uint32_t m_ElementSize = 0;
+		SerializedEncoding m_Encoding = SerializedEncoding::RAW;
+		std::uint16_t m_Flags = 0;
+		std::uint64_t m_Size = 0;
+	};
+
+	struct SerializedChunk {
+		std::uint64_t m_Bytes = 0;
+		std::uint64_t m_Count = 0;
+	};
+
+	//Fletcher style running sums over 32 bit words, cheap enough to keep up with memcpy.
+	class Checksum final {
+	public:
+		using size_type = std::size_t;
+
+	public:
+		inline void update(const void* data, size_type size) noexcept {
+			const unsigned char* Bytes = static_cast<const unsigned char*>(data);
+			for (; size > 0 && m_Pending > 0; size--)
+				push_byte(*Bytes++);
+			for (; size >= sizeof(std::uint32_t); size -= sizeof(std::uint32_t), Bytes += sizeof(std::uint32_t)) {
+				std::uint32_t Word;
+				std::memcpy(&Word, Bytes, sizeof(Word));
+				add(Word);
+			}
+			for (; size > 0; size--)
+				push_byte(*Bytes++);
+		}
+		inline std::uint64_t value() const noexcept {
+			//A word left open counts as if padded with zeros.
+			std::uint64_t Low = m_Low;
+			std::uint64_t High = m_High;
+			if (m_Pending > 0) {
+				Low += m_Word;
+				High += Low;
+			}
+			return Low ^ (High * 0x9E3779B97F4A7C15ull);
+		}
+
+	private:
+		inline void add(const std::uint32_t word) noexcept {
+			m_Low += word;
+			m_High += m_Low;
+		}
+		inline void push_byte(const unsigned char byte) noexcept {
+			m_Word |= static_cast<std::uint32_t>(byte) << (8 * m_Pending);
+			if (++m_Pending == sizeof(std::uint32_t)) {
+				add(m_Word);
+				m_Word = 0;
+				m_Pending = 0;
+			}
+		}
+
+	private:
+		std::uint64_t m_Low = 0;
+		std::uint64_t m_High = 0;
+		std::uint32_t m_Word = 0;
+		std::uint32_t m_Pending = 0;
+	};
+
+
+	class BinaryWriter;
+	class BinaryReader;
+
+	//Specialize to serialize element types that are not trivially copyable, see the string and Container ones below.
+	template<class T>
+	struct Serializer;
+
+	template<class T>
+	concept IsSerializable = std::is_trivially_copyable_v<T> || requires(BinaryWriter& writer, BinaryReader& reader, const T& value) {
+		Serializer<T>::write(writer, value);
+		{ Serializer<T>::read(reader) } -> std::convertible_to<T>;
+	};
+
+	//Encodes values into a byte Container, trivially copyable values as their bytes and anything else through its Serializer.
+	class BinaryWriter final {
+	public:
+		using size_type = std::size_t;
+		using Buffer = Container<unsigned char>;
+
+	public:
+		explicit BinaryWriter(Buffer& buffer) noexcept
+			: m_Buffer(buffer)
+		{
+		}
+
+		inline void write_bytes(const void* data, const size_type size) {
+			if (size == 0)
+				return;
+
+			std::memcpy(m_Buffer.grow_uninitialized(size), data, size);
+			m_Buffer.commit_uninitialized(size);
+		}
+
+		template<IsSerializable T>
+		inline void write(const T& value) {
+			if constexpr (std::is_trivially_copyable_v<T>)
+				write_bytes(std::addressof(value), sizeof(T));
+			else
+				Serializer<T>::write(*this, value);
+		}
+
+	private:
+		Buffer& m_Buffer;
+	};
+
+	//Decodes what BinaryWriter wrote, throws std::runtime_error when reading past the end.
+	class BinaryReader final {
+	public:
+		using size_type = std::size_t;
+
+	public:
+		BinaryReader(const unsigned char* data, const size_type size) noexcept
+			: m_Data(data), m_Remaining(size)
+		{
+		}
+
+		inline void read_bytes(void* destination, const size_type size) {
+			if (size > m_Remaining)
+				throw std::runtime_error("Serialized container is truncated");
+
+			if (size > 0)
+				std::memcpy(destination, m_Data, size);
+			m_Data += size;
+			m_Remaining -= size;
+		}
+
+		template<IsSerializable T>
+		inline T read() {
+			if constexpr (std::is_trivially_copyable_v<T>) {
+				//The bytes become a T by copying them into the object representation of one.
+				alignas(T) unsigned char Storage[sizeof(T)];
+				read_bytes(Storage, sizeof(T));
+				return *std::launder(reinterpret_cast<T*>(Storage));
+			}
+			else
+				return Serializer<T>::read(*this);
+		}
+
+		inline size_type remaining() const noexcept { return m_Remaining; }
+
+	private:
+		const unsigned char* m_Data;
+		size_type m_Remaining;
+	};
+
+	template<class Char, class Traits, class Alloc>
+		requires std::is_trivially_copyable_v<Char>
+	struct Serializer<std::basic_string<Char, Traits, Alloc>> {
+		using Type = std::basic_string<Char, Traits, Alloc>;
+
+		static inline void write(BinaryWriter& writer, const Type& value) {
+			writer.write(static_cast<std::uint64_t>(value.size()));
+			writer.write_bytes(value.data(), value.size() * sizeof(Char));
+		}
+		static inline Type read(BinaryReader& reader) {
+			const std::uint64_t Size = reader.read<std::uint64_t>();
+			if (Size > reader.remaining() / sizeof(Char))
+				throw std::runtime_error("Serialized container is truncated");
+
+			Type Result(static_cast<std::size_t>(Size), Char());
+			reader.read_bytes(Result.data(), Result.size() * sizeof(Char));
+			return Result;
+		}
+	};
+
+	template<IsSerializable T, class Alloc, std::size_t InlineCapacity, class Growth>
+	struct Serializer<Container<T, Alloc, InlineCapacity, Growth>> {
+		using Type = Container<T, Alloc, InlineCapacity, Growth>;
+
+		static inline void write(BinaryWriter& writer, const Type& value) {
+			writer.write(static_cast<std::uint64_t>(value.size()));
+			if constexpr (std::is_trivially_copyable_v<T>)
+				writer.write_bytes(value.data(), value.size() * sizeof(T));
+			else {
+				for (const T& Element : value)
+					writer.write(Element);
+			}
+		}
+		static inline Type read(BinaryReader& reader) {
+			//The reservation is capped by the bytes left, a corrupt size must not allocate more than the data could fill.
+			const std::uint64_t Size = reader.read<std::uint64_t>();
+			Type Result;
+			Result.reserve(static_cast<std::size_t>(Size < reader.remaining() ? Size : reader.remaining()));
+			for (std::uint64_t i = 0; i < Size; i++)
+				Result.emplace_back(reader.read<T>());
+			return Result;
+		}
+	};
+
+
+	namespace Serialization {
+		using size_type = std::size_t;
+
+		template<class T>
+		inline constexpr SerializedEncoding ENCODING = std::is_trivially_copyable_v<T> ? SerializedEncoding::RAW : SerializedEncoding::CHUNKED;
+		template<class T>
+		inline constexpr size_type DATA_OFFSET = (sizeof(SerializedHeader) + alignof(T) - 1) & ~(alignof(T) - 1);
+
+		struct StreamSink {
+			std::ostream& m_Stream;
+
+			inline void write(const void* data, const size_type size) {
+				if (!m_Stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size)))
+					throw std::runtime_error("Failed to write serialized container");
+			}
+		};
+		struct BufferSink {
+			Container<unsigned char>& m_Buffer;
+
+			inline void write(const void* data, const size_type size) {
+				BinaryWriter(m_Buffer).write_bytes(data, size);
+			}
+		};
+		struct StreamSource {
+			std::istream& m_Stream;
+
+			inline void read_bytes(void* destination, const size_type size) {
+				if (!m_Stream.read(static_cast<char*>(destination), static_cast<std::streamsize>(size)))
+					throw std::runtime_error("Serialized container is truncated");
+			}
+		};
+		using BufferSource = BinaryReader;
+
+		//Feeds everything passing through to the checksum when the stream carries one.
+		//Sinks provide write(data, size), sources read_bytes(destination, size) like BinaryReader.
+		template<class Inner>
+		struct Checksummed {
+			Inner& m_Inner;
+			bool m_Enabled;
+			Checksum m_Checksum;
+
+			inline void write(const void* data, const size_type size) {
+				m_Inner.write(data, size);
+				if (m_Enabled)
+					m_Checksum.update(data, size);
+			}
+			inline void read(void* destination, const size_type size) {
+				m_Inner.read_bytes(destination, size);
+				if (m_Enabled)
+					m_Checksum.update(destination, size);
+			}
+		};
+
+		template<class T>
+		inline void validate(const SerializedHeader& header) {
+			if (header.m_Magic != SERIALIZED_MAGIC)
+				throw std::runtime_error("Data is not a serialized container");
+			if (header.m_ByteOrder != SERIALIZED_BYTE_ORDER)
+				throw std::runtime_error("Serialized container was written with a different byte order");
+			if (header.m_FormatVersion != SERIALIZED_FORMAT_VERSION)
+				throw std::runtime_error("Serialized container format version mismatch");
+			if (header.m_ElementSize != sizeof(T) || header.m_Encoding != ENCODING<T>)
+				throw std::runtime_error("Serialized container element layout mismatch");
+		}
+
+		template<class Sink, class T, class Alloc, std::size_t InlineCapacity, class Growth>
+		inline void write(Sink& sink, const Container<T, Alloc, InlineCapacity, Growth>& container, const bool checksum) {
+			SerializedHeader Header;
+			Header.m_ElementSize = static_cast<std::uint32_t>(sizeof(T));
+			Header.m_Encoding = ENCODING<T>;
+			Header.m_Flags = checksum ? SERIALIZED_FLAG_CHECKSUM : 0;
+			Header.m_Size = container.size();
+			sink.write(&Header, sizeof(Header));
+
+			Checksummed<Sink> Body{ sink, checksum, {} };
+			if constexpr (ENCODING<T> == SerializedEncoding::RAW) {
+				const unsigned char Padding[alignof(T)] = {};
+				Body.write(Padding, DATA_OFFSET<T> - sizeof(SerializedHeader));
+				if (!container.empty())
+					Body.write(container.data(), container.size() * sizeof(T));
+			}
+			else {
+				Container<unsigned char> Chunk;
+				BinaryWriter Writer(Chunk);
+				SerializedChunk Frame;
+
+				const auto Emit = [&]() {
+					Frame.m_Bytes = Chunk.size();
+					Body.write(&Frame, sizeof(Frame));
+					Body.write(Chunk.data(), Chunk.size());
+					Chunk.clear();
+					Frame.m_Count = 0;
+				};
+
+				for (const T& Element : container) {
+					Writer.write(Element);
+					Frame.m_Count++;
+					if (Chunk.size() >= SERIALIZED_CHUNK_SIZE)
+						Emit();
+				}
+				if (Frame.m_Count > 0)
+					Emit();
+
+				const SerializedChunk End;
+				Body.write(&End, sizeof(End));
+			}
+
+			if (checksum) {
+				const std::uint64_t Value = Body.m_Checksum.value();
+				sink.write(&Value, sizeof(Value));
+			}
+		}
+
+		template<class Source, class T, class Alloc, std::size_t InlineCapacity, class Growth>
+		inline void read(Source& source, Container<T, Alloc, InlineCapacity, Growth>& container) {
+			using Target = Container<T, Alloc, InlineCapacity, Growth>;
+
+			SerializedHeader Header;
+			source.read_bytes(&Header, sizeof(Header));
+			validate<T>(Header);
+
+			//Filled on the side so the target is untouched if the data turns out to be broken. The size in the
+			//header is not trusted for allocation, elements are added as they actually arrive.
+			Target Result(container.get_allocator());
+			Checksummed<Source> Body{ source, (Header.m_Flags & SERIALIZED_FLAG_CHECKSUM) != 0, {} };
+			if constexpr (ENCODING<T> == SerializedEncoding::RAW) {
+				unsigned char Padding[alignof(T)];
+				Body.read(Padding, DATA_OFFSET<T> - sizeof(SerializedHeader));
+
+				constexpr size_type BLOCK = SERIALIZED_CHUNK_SIZE / sizeof(T) > 0 ? SERIALIZED_CHUNK_SIZE / sizeof(T) : 1;
+				for (std::uint64_t Remaining = Header.m_Size; Remaining > 0;) {
+					const size_type Count = Remaining < BLOCK ? static_cast<size_type>(Remaining) : BLOCK;
+					if constexpr (std::is_trivially_default_constructible_v<T>) {
+						Body.read(Result.grow_uninitialized(Count), Count * sizeof(T));
+						Result.commit_uninitialized(Count);
+					}
+					else {
+						for (size_type i = 0; i < Count; i++) {
+							alignas(T) unsigned char Storage[sizeof(T)];
+							Body.read(Storage, sizeof(T));
+							Result.push_back(*std::launder(reinterpret_cast<T*>(Storage)));
+						}
+					}
+					Remaining -= Count;
+				}
+			}
+			else {
+				Container<unsigned char> Chunk;
+				for (;;) {
+					SerializedChunk Frame;
+					Body.read(&Frame, sizeof(Frame));
+					if (Frame.m_Bytes == 0 && Frame.m_Count == 0)
+						break;
+
+					//Frame sizes are untrusted too, a buffer has to hold the whole frame and a stream is read a chunk at a time.
+					if constexpr (std::is_same_v<Source, BufferSource>) {
+						if (Frame.m_Bytes > source.remaining())
+							throw std::runtime_error("Serialized container is truncated");
+					}
+
+					Chunk.clear();
+					for (std::uint64_t Left = Frame.m_Bytes; Left > 0;) {
+						const size_type Piece = Left < SERIALIZED_CHUNK_SIZE ? static_cast<size_type>(Left) : SERIALIZED_CHUNK_SIZE;
+						Body.read(Chunk.grow_uninitialized(Piece), Piece);
+						Chunk.commit_uninitialized(Piece);
+						Left -= Piece;
+					}
+
+					BinaryReader Reader(Chunk.data(), Chunk.size());
+					for (std::uint64_t i = 0; i < Frame.m_Count; i++)
+						Result.emplace_back(Reader.read<T>());
+					if (Reader.remaining() != 0)
+						throw std::runtime_error("Serialized container chunk is corrupt");
+				}
+
+				if (Result.size() != Header.m_Size)
+					throw std::runtime_error("Serialized container element count mismatch");
+			}
+
+			if (Body.m_Enabled) {
+				std::uint64_t Stored;
+				source.read_bytes(&Stored, sizeof(Stored));
+				if (Stored != Body.m_Checksum.value())
+					throw std::runtime_error("Serialized container checksum mismatch");
+			}
+
+			container = std::move(Result);
+		}
+	}
+
+	//Writes container to stream. Trivially copyable elements go out as a single block, anything else in chunks.
+	template<IsSerializable T, class Alloc, std::size_t InlineCapacity, class Growth>
+	inline void serialize(std::ostream& stream, const Container<T, Alloc, InlineCapacity, Growth>& container, const bool checksum = false) {
+		Serialization::StreamSink Sink{ stream };
+		Serialization::write(Sink, container, checksum);
+	}
+	//Appends the serialized container to buffer, e.g. to hand it to a ContainerView or a socket.
+	template<IsSerializable T, class Alloc, std::size_t InlineCapacity, class Growth>
+	inline void serialize(Container<unsigned char>& buffer, const Container<T, Alloc, InlineCapacity, Growth>& container, const bool checksum = false) {
+		Serialization::BufferSink Sink{ buffer };
+		Serialization::write(Sink, container, checksum);
+	}
+
+	//Replaces the contents of container with what stream holds. Throws std::runtime_error on malformed data,
+	//container is left untouched in that case.
+	template<IsSerializable T, class Alloc, std::size_t InlineCapacity, class Growth>
+	inline void deserialize(std::istream& stream, Container<T, Alloc, InlineCapacity, Growth>& container) {
+		Serialization::StreamSource Source{ stream };
+		Serialization::read(Source, container);
+	}
+	template<IsSerializable T, class Alloc, std::size_t InlineCapacity, class Growth>
+	inline void deserialize(const void* data, const std::size_t size, Container<T, Alloc, InlineCapacity, Growth>& container) {
+		Serialization::BufferSource Source(static_cast<const unsigned char*>(data), size);
+		Serialization::read(Source, container);
+	}
+
+
+	//Read only view of a serialized container of trivially copyable elements, the elements are used where they lie
+	//in the buffer. The buffer has to stay alive and be aligned for T, throws std::runtime_error otherwise.
+	template<class T>
+	class ContainerView final {
+	public:
+		using Type = T;
+		using SizeType = std::size_t;
+		using ConstantPointer = const T*;
+		using ReverseConstantIterator = std::reverse_iterator<ConstantPointer>;
+		using ConstantReference = const T&;
+		using DifferenceType = std::ptrdiff_t;
+
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be viewed in place.");
+
+	public:
+		constexpr ContainerView() noexcept = default;
+		ContainerView(const void* data, const SizeType size)
+			: m_Buffer(static_cast<const unsigned char*>(data))
+		{
+			if (size < Serialization::DATA_OFFSET<T>)
+				throw std::runtime_error("Serialized container is truncated");
+
+			SerializedHeader Header;
+			std::memcpy(&Header, m_Buffer, sizeof(Header));
+			Serialization::validate<T>(Header);
+
+			const SizeType Available = size - Serialization::DATA_OFFSET<T>;
+			m_Checksummed = (Header.m_Flags & SERIALIZED_FLAG_CHECKSUM) != 0;
+			if (Header.m_Size > Available / sizeof(T) || (m_Checksummed && Available - Header.m_Size * sizeof(T) < sizeof(std::uint64_t)))
+				throw std::runtime_error("Serialized container is truncated");
+
+			m_Data = reinterpret_cast<ConstantPointer>(m_Buffer + Serialization::DATA_OFFSET<T>);
+			if (reinterpret_cast<std::uintptr_t>(m_Data) % alignof(T) != 0)
+				throw std::runtime_error("Serialized container is not aligned for its element type");
+
+			m_Size = static_cast<SizeType>(Header.m_Size);
+		}
+		template<class Alloc, std::size_t InlineCapacity, class Growth>
+		explicit ContainerView(const Container<unsigned char, Alloc, InlineCapacity, Growth>& buffer)
+			: ContainerView(buffer.data(), buffer.size())
+		{
+		}
+
+	public:
+		//Recomputes the checksum, true as well when the data was written without one.
+		inline bool verify() const noexcept {
+			if (!m_Checksummed)
+				return true;
+
+			const SizeType Bytes = Serialization::DATA_OFFSET<T> - sizeof(SerializedHeader) + m_Size * sizeof(T);
+			Checksum Computed;
+			Computed.update(m_Buffer + sizeof(SerializedHeader), Bytes);
+
+			std::uint64_t Stored;
+			std::memcpy(&Stored, m_Buffer + sizeof(SerializedHeader) + Bytes, sizeof(Stored));
+			return Stored == Computed.value();
+		}
+		inline bool has_checksum() const noexcept { return m_Checksummed; }
+
+	public: //Access
+		inline ConstantReference at(SizeType index) const {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - index out of range");
+
+			return m_Data[index];
+		}
+		inline ConstantReference operator[](SizeType index) const noexcept {
+			assert(index < size() && "Index out of range");
+			return m_Data[index];
+		}
+
+		inline ConstantPointer data() const noexcept { return m_Data; }
+		inline ConstantReference front() const noexcept { return m_Data[0]; }
+		inline ConstantReference back() const noexcept { return m_Data[m_Size - 1]; }
+
+		inline SizeType size() const noexcept { return m_Size; }
+		inline bool empty() const noexcept { return m_Size == 0; }
+
+	public: //Iterators
+		inline ConstantPointer begin() const noexcept { return m_Data; }
+		inline ConstantPointer cbegin() const noexcept { return m_Data; }
+		inline ConstantPointer end() const noexcept { return m_Data + m_Size; }
+		inline ConstantPointer cend() const noexcept { return m_Data + m_Size; }
+
+		inline ReverseConstantIterator rbegin() const noexcept { return ReverseConstantIterator(end()); }
+		inline ReverseConstantIterator crbegin() const noexcept { return ReverseConstantIterator(end()); }
+		inline ReverseConstantIterator rend() const noexcept { return ReverseConstantIterator(begin()); }
+		inline ReverseConstantIterator crend() const noexcept { return ReverseConstantIterator(begin()); }
+
+	private:
+		const unsigned char* m_Buffer = nullptr;
+		ConstantPointer m_Data = nullptr;
+		SizeType m_Size = 0;
+		bool m_Checksummed = false;
+	};
+}
+
+#endif // !SERIALIZATION_H
@@ -0,0 +1,554 @@
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <numeric>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MARIGOLD_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#endif
+
+
+#ifndef SIMD_H
+#define SIMD_H
+
+
+//Lets the kernels of one instruction set use its intrinsics without compiling the whole program for it.
+#define MARIGOLD_STRINGIFY(x) #x
+#if defined(__clang__)
+#define MARIGOLD_TARGET_BEGIN(isa) _Pragma(MARIGOLD_STRINGIFY(clang attribute push(__attribute__((target(isa))), apply_to = function)))
+#define MARIGOLD_TARGET_END _Pragma("clang attribute pop")
+#elif defined(__GNUC__)
+#define MARIGOLD_TARGET_BEGIN(isa) _Pragma("GCC push_options") _Pragma(MARIGOLD_STRINGIFY(GCC target(isa)))
+#define MARIGOLD_TARGET_END _Pragma("GCC pop_options")
+#else
+#define MARIGOLD_TARGET_BEGIN(isa)
+#define MARIGOLD_TARGET_END
+#endif
+
+
+namespace Marigold {
+
+	enum class SimdLevel {
+		SCALAR = 0,
+		SSE2,
+		AVX2,
+		AVX512
+	};
+
+	namespace Simd {
+
+		//Element types the kernels run on, unsigned integers share the lanes of their signed counterparts.
+		template<class T>
+		using LaneType = std::conditional_t<std::is_same_v<T, float> || std::is_same_v<T, double>, T,
+			std::conditional_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) == 4, std::int32_t,
+			std::conditional_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) == 8, std::int64_t, void>>>;
+
+		template<class T>
+		concept HasLane = !std::is_void_v<LaneType<T>>;
+
+		//Ordering of unsigned integers differs from their lanes, so min/max only vectorize signed and floating point types.
+		template<class T>
+		concept HasOrderedLane = HasLane<T> && (std::is_floating_point_v<T> || std::is_signed_v<T>);
+
+		inline SimdLevel detect_level() noexcept {
+#if !defined(MARIGOLD_SIMD_X86)
+			return SimdLevel::SCALAR;
+#elif defined(_MSC_VER) && !defined(__clang__)
+			int Info[4];
+			__cpuid(Info, 0);
+			const int MaxLeaf = Info[0];
+
+			__cpuid(Info, 1);
+			const bool Sse2 = (Info[3] & (1 << 26)) != 0;
+			const bool OsSavesState = (Info[2] & (1 << 27)) != 0;
+			const unsigned long long EnabledState = OsSavesState ? _xgetbv(0) : 0;
+
+			bool Avx2 = false;
+			bool Avx512 = false;
+			if (MaxLeaf >= 7) {
+				__cpuidex(Info, 7, 0);
+				Avx2 = (Info[1] & (1 << 5)) != 0 && (EnabledState & 0x6) == 0x6;
+				Avx512 = (Info[1] & (1 << 16)) != 0 && (EnabledState & 0xE6) == 0xE6;
+			}
+
+			if (Avx512)
+				return SimdLevel::AVX512;
+			if (Avx2)
+				return SimdLevel::AVX2;
+			return Sse2 ? SimdLevel::SSE2 : SimdLevel::SCALAR;
+#else
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f"))
+				return SimdLevel::AVX512;
+			if (__builtin_cpu_supports("avx2"))
+				return SimdLevel::AVX2;
+			if (__builtin_cpu_supports("sse2"))
+				return SimdLevel::SSE2;
+			return SimdLevel::SCALAR;
+#endif
+		}
+
+		inline std::atomic<SimdLevel>& level_limit() noexcept {
+			static std::atomic<SimdLevel> Limit{ SimdLevel::AVX512 };
+			return Limit;
+		}
+		inline SimdLevel level() noexcept {
+			static const SimdLevel Detected = detect_level();
+			const SimdLevel Limit = level_limit().load(std::memory_order_relaxed);
+			return Detected < Limit ? Detected : Limit;
+		}
+		inline void limit_level(const SimdLevel limit) noexcept {
+			//Caps dispatch below what the CPU supports, mostly useful for comparing kernels against each other.
+			level_limit().store(limit, std::memory_order_relaxed);
+		}
+
+		//Hints that the cache line holding address is about to be read. The address does not have to be valid.
+		inline void prefetch(const void* address) noexcept {
+#if defined(MARIGOLD_SIMD_X86)
+			_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+			(void)address;
+#endif
+		}
+
+		//Bit packed blocks hold PACKED_BLOCK values of width bits in PACKED_LANES interleaved 32-bit streams. Value i
+		//goes to stream i % PACKED_LANES, so a block of width bits takes width * PACKED_LANES words and one 128-bit
+		//register decodes a row of values at a time.
+		inline constexpr std::size_t PACKED_LANES = 4;
+		inline constexpr std::size_t PACKED_ROWS = 32;
+		inline constexpr std::size_t PACKED_BLOCK = PACKED_LANES * PACKED_ROWS;
+
+		constexpr inline std::size_t packed_words(const unsigned width) noexcept {
+			return width * PACKED_LANES;
+		}
+
+		//Writes the low width bits of each of the PACKED_BLOCK values into packed_words(width) words.
+		inline void pack(const std::uint32_t* values, const unsigned width, std::uint32_t* words) noexcept {
+			std::fill_n(words, packed_words(width), 0u);
+			if (width == 0)
+				return;
+
+			for (std::size_t i = 0; i < PACKED_BLOCK; i++) {
+				const std::size_t Lane = i % PACKED_LANES;
+				const std::size_t Bit = (i / PACKED_LANES) * width;
+				const std::size_t Word = Bit / 32;
+				const unsigned Shift = static_cast<unsigned>(Bit % 32);
+				words[Word * PACKED_LANES + Lane] |= values[i] << Shift;
+				if (Shift + width > 32)
+					words[(Word + 1) * PACKED_LANES + Lane] |= values[i] >> (32 - Shift);
+			}
+		}
+
+		//Reads value index of a packed block without decoding the rest.
+		inline std::uint32_t unpack_one(const std::uint32_t* words, const unsigned width, const std::size_t index) noexcept {
+			if (width == 0)
+				return 0;
+
+			const std::size_t Lane = index % PACKED_LANES;
+			const std::size_t Bit = (index / PACKED_LANES) * width;
+			const std::size_t Word = Bit / 32;
+			const unsigned Shift = static_cast<unsigned>(Bit % 32);
+			std::uint32_t Value = words[Word * PACKED_LANES + Lane] >> Shift;
+			if (Shift + width > 32)
+				Value |= words[(Word + 1) * PACKED_LANES + Lane] << (32 - Shift);
+
+			return width == 32 ? Value : Value & ((1u << width) - 1);
+		}
+
+
+#if defined(MARIGOLD_SIMD_X86)
+MARIGOLD_TARGET_BEGIN("sse2")
+		namespace Sse2 {
+			template<class Lane>
+			struct Ops;
+
+			template<>
+			struct Ops<float> {
+				using Register = __m128;
+				static constexpr std::size_t LANES = 4;
+
+				static inline Register load(const float* address) noexcept { return _mm_loadu_ps(address); }
+				static inline void store(float* address, const Register value) noexcept { _mm_storeu_ps(address, value); }
+				static inline Register broadcast(const float value) noexcept { return _mm_set1_ps(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm_movemask_ps(_mm_cmpeq_ps(lhs, rhs))); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm_add_ps(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm_min_ps(lhs, rhs); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm_max_ps(lhs, rhs); }
+			};
+			template<>
+			struct Ops<double> {
+				using Register = __m128d;
+				static constexpr std::size_t LANES = 2;
+
+				static inline Register load(const double* address) noexcept { return _mm_loadu_pd(address); }
+				static inline void store(double* address, const Register value) noexcept { _mm_storeu_pd(address, value); }
+				static inline Register broadcast(const double value) noexcept { return _mm_set1_pd(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm_movemask_pd(_mm_cmpeq_pd(lhs, rhs))); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm_add_pd(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm_min_pd(lhs, rhs); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm_max_pd(lhs, rhs); }
+			};
+			template<>
+			struct Ops<std::int32_t> {
+				using Register = __m128i;
+				static constexpr std::size_t LANES = 4;
+
+				static inline Register load(const std::int32_t* address) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(address)); }
+				static inline void store(std::int32_t* address, const Register value) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(address), value); }
+				static inline Register broadcast(const std::int32_t value) noexcept { return _mm_set1_epi32(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(lhs, rhs)))); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm_add_epi32(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept {
+					//SSE2 has no 32-bit min, select through the comparison mask instead.
+					const Register Greater = _mm_cmpgt_epi32(lhs, rhs);
+					return _mm_or_si128(_mm_and_si128(Greater, rhs), _mm_andnot_si128(Greater, lhs));
+				}
+				static inline Register max(const Register lhs, const Register rhs) noexcept {
+					const Register Greater = _mm_cmpgt_epi32(lhs, rhs);
+					return _mm_or_si128(_mm_and_si128(Greater, lhs), _mm_andnot_si128(Greater, rhs));
+				}
+			};
+			template<>
+			struct Ops<std::int64_t> {
+				using Register = __m128i;
+				static constexpr std::size_t LANES = 2;
+
+				static inline Register load(const std::int64_t* address) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(address)); }
+				static inline void store(std::int64_t* address, const Register value) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(address), value); }
+				static inline Register broadcast(const std::int64_t value) noexcept { return _mm_set1_epi64x(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept {
+					//64-bit equality is both 32-bit halves being equal.
+					const Register Halves = _mm_cmpeq_epi32(lhs, rhs);
+					const Register Equal = _mm_and_si128(Halves, _mm_shuffle_epi32(Halves, _MM_SHUFFLE(2, 3, 0, 1)));
+					return static_cast<std::uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(Equal)));
+				}
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm_add_epi64(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept {
+					//64-bit comparisons only arrive with SSE4.2, two lanes are cheap enough to do by hand.
+					std::int64_t Left[LANES], Right[LANES];
+					store(Left, lhs);
+					store(Right, rhs);
+					return _mm_set_epi64x(Left[1] < Right[1] ? Left[1] : Right[1], Left[0] < Right[0] ? Left[0] : Right[0]);
+				}
+				static inline Register max(const Register lhs, const Register rhs) noexcept {
+					std::int64_t Left[LANES], Right[LANES];
+					store(Left, lhs);
+					store(Right, rhs);
+					return _mm_set_epi64x(Left[1] > Right[1] ? Left[1] : Right[1], Left[0] > Right[0] ? Left[0] : Right[0]);
+				}
+			};
+
+#include "SimdKernels.inl"
+
+			inline void unpack(const std::uint32_t* words, const unsigned width, std::uint32_t* out) noexcept {
+				//Every lane holds its own stream, so one shift and mask decodes four values and the shifts are
+				//the same for all of them.
+				const __m128i Mask = _mm_set1_epi32(static_cast<int>(width == 32 ? ~0u : (1u << width) - 1));
+				for (unsigned Row = 0; Row < PACKED_ROWS; Row++) {
+					const unsigned Bit = Row * width;
+					const unsigned Word = Bit / 32;
+					const unsigned Shift = Bit % 32;
+					__m128i Value = _mm_srl_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words + Word * PACKED_LANES)), _mm_cvtsi32_si128(static_cast<int>(Shift)));
+					if (Shift + width > 32) {
+						const __m128i Next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + (Word + 1) * PACKED_LANES));
+						Value = _mm_or_si128(Value, _mm_sll_epi32(Next, _mm_cvtsi32_si128(static_cast<int>(32 - Shift))));
+					}
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + Row * PACKED_LANES), _mm_and_si128(Value, Mask));
+				}
+			}
+		}
+MARIGOLD_TARGET_END
+
+MARIGOLD_TARGET_BEGIN("avx2")
+		namespace Avx2 {
+			template<class Lane>
+			struct Ops;
+
+			template<>
+			struct Ops<float> {
+				using Register = __m256;
+				static constexpr std::size_t LANES = 8;
+
+				static inline Register load(const float* address) noexcept { return _mm256_loadu_ps(address); }
+				static inline void store(float* address, const Register value) noexcept { _mm256_storeu_ps(address, value); }
+				static inline Register broadcast(const float value) noexcept { return _mm256_set1_ps(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ))); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm256_add_ps(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm256_min_ps(lhs, rhs); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm256_max_ps(lhs, rhs); }
+			};
+			template<>
+			struct Ops<double> {
+				using Register = __m256d;
+				static constexpr std::size_t LANES = 4;
+
+				static inline Register load(const double* address) noexcept { return _mm256_loadu_pd(address); }
+				static inline void store(double* address, const Register value) noexcept { _mm256_storeu_pd(address, value); }
+				static inline Register broadcast(const double value) noexcept { return _mm256_set1_pd(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm256_movemask_pd(_mm256_cmp_pd(lhs, rhs, _CMP_EQ_OQ))); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm256_add_pd(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm256_min_pd(lhs, rhs); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm256_max_pd(lhs, rhs); }
+			};
+			template<>
+			struct Ops<std::int32_t> {
+				using Register = __m256i;
+				static constexpr std::size_t LANES = 8;
+
+				static inline Register load(const std::int32_t* address) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(address)); }
+				static inline void store(std::int32_t* address, const Register value) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(address), value); }
+				static inline Register broadcast(const std::int32_t value) noexcept { return _mm256_set1_epi32(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(lhs, rhs)))); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm256_add_epi32(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm256_min_epi32(lhs, rhs); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm256_max_epi32(lhs, rhs); }
+			};
+			template<>
+			struct Ops<std::int64_t> {
+				using Register = __m256i;
+				static constexpr std::size_t LANES = 4;
+
+				static inline Register load(const std::int64_t* address) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(address)); }
+				static inline void store(std::int64_t* address, const Register value) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(address), value); }
+				static inline Register broadcast(const std::int64_t value) noexcept { return _mm256_set1_epi64x(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lhs, rhs)))); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm256_add_epi64(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm256_blendv_epi8(lhs, rhs, _mm256_cmpgt_epi64(lhs, rhs)); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm256_blendv_epi8(rhs, lhs, _mm256_cmpgt_epi64(lhs, rhs)); }
+			};
+
+#include "SimdKernels.inl"
+		}
+MARIGOLD_TARGET_END
+
+MARIGOLD_TARGET_BEGIN("avx512f")
+		namespace Avx512 {
+			template<class Lane>
+			struct Ops;
+
+			template<>
+			struct Ops<float> {
+				using Register = __m512;
+				static constexpr std::size_t LANES = 16;
+
+				static inline Register load(const float* address) noexcept { return _mm512_loadu_ps(address); }
+				static inline void store(float* address, const Register value) noexcept { _mm512_storeu_ps(address, value); }
+				static inline Register broadcast(const float value) noexcept { return _mm512_set1_ps(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm512_cmp_ps_mask(lhs, rhs, _CMP_EQ_OQ)); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm512_add_ps(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm512_min_ps(lhs, rhs); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm512_max_ps(lhs, rhs); }
+				static inline Register compress(const Register value, const std::uint64_t keep) noexcept { return _mm512_maskz_compress_ps(static_cast<__mmask16>(keep), value); }
+			};
+			template<>
+			struct Ops<double> {
+				using Register = __m512d;
+				static constexpr std::size_t LANES = 8;
+
+				static inline Register load(const double* address) noexcept { return _mm512_loadu_pd(address); }
+				static inline void store(double* address, const Register value) noexcept { _mm512_storeu_pd(address, value); }
+				static inline Register broadcast(const double value) noexcept { return _mm512_set1_pd(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm512_cmp_pd_mask(lhs, rhs, _CMP_EQ_OQ)); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm512_add_pd(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm512_min_pd(lhs, rhs); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm512_max_pd(lhs, rhs); }
+				static inline Register compress(const Register value, const std::uint64_t keep) noexcept { return _mm512_maskz_compress_pd(static_cast<__mmask8>(keep), value); }
+			};
+			template<>
+			struct Ops<std::int32_t> {
+				using Register = __m512i;
+				static constexpr std::size_t LANES = 16;
+
+				static inline Register load(const std::int32_t* address) noexcept { return _mm512_loadu_si512(address); }
+				static inline void store(std::int32_t* address, const Register value) noexcept { _mm512_storeu_si512(address, value); }
+				static inline Register broadcast(const std::int32_t value) noexcept { return _mm512_set1_epi32(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm512_cmpeq_epi32_mask(lhs, rhs)); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm512_add_epi32(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm512_min_epi32(lhs, rhs); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm512_max_epi32(lhs, rhs); }
+				static inline Register compress(const Register value, const std::uint64_t keep) noexcept { return _mm512_maskz_compress_epi32(static_cast<__mmask16>(keep), value); }
+			};
+			template<>
+			struct Ops<std::int64_t> {
+				using Register = __m512i;
+				static constexpr std::size_t LANES = 8;
+
+				static inline Register load(const std::int64_t* address) noexcept { return _mm512_loadu_si512(address); }
+				static inline void store(std::int64_t* address, const Register value) noexcept { _mm512_storeu_si512(address, value); }
+				static inline Register broadcast(const std::int64_t value) noexcept { return _mm512_set1_epi64(value); }
+				static inline std::uint64_t equal_mask(const Register lhs, const Register rhs) noexcept { return static_cast<std::uint64_t>(_mm512_cmpeq_epi64_mask(lhs, rhs)); }
+				static inline Register add(const Register lhs, const Register rhs) noexcept { return _mm512_add_epi64(lhs, rhs); }
+				static inline Register min(const Register lhs, const Register rhs) noexcept { return _mm512_min_epi64(lhs, rhs); }
+				static inline Register max(const Register lhs, const Register rhs) noexcept { return _mm512_max_epi64(lhs, rhs); }
+				static inline Register compress(const Register value, const std::uint64_t keep) noexcept { return _mm512_maskz_compress_epi64(static_cast<__mmask8>(keep), value); }
+			};
+
+#include "SimdKernels.inl"
+		}
+MARIGOLD_TARGET_END
+#endif
+
+
+		//Entry points, pick the widest kernel the CPU supports and fall back to the standard algorithms otherwise.
+		template<class T>
+		inline const T* find(const T* first, const std::size_t count, const T& value) noexcept {
+			if constexpr (HasLane<T>) {
+#if defined(MARIGOLD_SIMD_X86)
+				using Lane = LaneType<T>;
+				const Lane* Data = reinterpret_cast<const Lane*>(first);
+				const Lane Needle = std::bit_cast<Lane>(value);
+				switch (level()) {
+				case SimdLevel::AVX512: return reinterpret_cast<const T*>(Avx512::find(Data, count, Needle));
+				case SimdLevel::AVX2: return reinterpret_cast<const T*>(Avx2::find(Data, count, Needle));
+				case SimdLevel::SSE2: return reinterpret_cast<const T*>(Sse2::find(Data, count, Needle));
+				default: break;
+				}
+#endif
+			}
+
+			return std::find(first, first + count, value);
+		}
+
+		template<class T>
+		inline std::size_t count(const T* first, const std::size_t count, const T& value) noexcept {
+			if constexpr (HasLane<T>) {
+#if defined(MARIGOLD_SIMD_X86)
+				using Lane = LaneType<T>;
+				const Lane* Data = reinterpret_cast<const Lane*>(first);
+				const Lane Needle = std::bit_cast<Lane>(value);
+				switch (level()) {
+				case SimdLevel::AVX512: return Avx512::count(Data, count, Needle);
+				case SimdLevel::AVX2: return Avx2::count(Data, count, Needle);
+				case SimdLevel::SSE2: return Sse2::count(Data, count, Needle);
+				default: break;
+				}
+#endif
+			}
+
+			return static_cast<std::size_t>(std::count(first, first + count, value));
+		}
+
+		template<class T>
+		inline T sum(const T* first, const std::size_t count) noexcept {
+			//Floating point sums are reassociated across lanes, so rounding can differ from a sequential sum.
+			if constexpr (HasLane<T>) {
+#if defined(MARIGOLD_SIMD_X86)
+				using Lane = LaneType<T>;
+				const Lane* Data = reinterpret_cast<const Lane*>(first);
+				switch (level()) {
+				case SimdLevel::AVX512: return std::bit_cast<T>(Avx512::sum(Data, count));
+				case SimdLevel::AVX2: return std::bit_cast<T>(Avx2::sum(Data, count));
+				case SimdLevel::SSE2: return std::bit_cast<T>(Sse2::sum(Data, count));
+				default: break;
+				}
+#endif
+			}
+
+			return std::accumulate(first, first + count, T(0));
+		}
+
+		template<class T>
+		inline T minimum(const T* first, const std::size_t count) noexcept {
+			//Expects count > 0, ordering of NaN values is unspecified.
+			if constexpr (HasOrderedLane<T>) {
+#if defined(MARIGOLD_SIMD_X86)
+				using Lane = LaneType<T>;
+				const Lane* Data = reinterpret_cast<const Lane*>(first);
+				switch (level()) {
+				case SimdLevel::AVX512: return static_cast<T>(Avx512::minimum(Data, count));
+				case SimdLevel::AVX2: return static_cast<T>(Avx2::minimum(Data, count));
+				case SimdLevel::SSE2: return static_cast<T>(Sse2::minimum(Data, count));
+				default: break;
+				}
+#endif
+			}
+
+			return *std::min_element(first, first + count);
+		}
+
+		template<class T>
+		inline T maximum(const T* first, const std::size_t count) noexcept {
+			//Expects count > 0, ordering of NaN values is unspecified.
+			if constexpr (HasOrderedLane<T>) {
+#if defined(MARIGOLD_SIMD_X86)
+				using Lane = LaneType<T>;
+				const Lane* Data = reinterpret_cast<const Lane*>(first);
+				switch (level()) {
+				case SimdLevel::AVX512: return static_cast<T>(Avx512::maximum(Data, count));
+				case SimdLevel::AVX2: return static_cast<T>(Avx2::maximum(Data, count));
+				case SimdLevel::SSE2: return static_cast<T>(Sse2::maximum(Data, count));
+				default: break;
+				}
+#endif
+			}
+
+			return *std::max_element(first, first + count);
+		}
+
+		template<class T>
+		inline bool equal(const T* lhs, const T* rhs, const std::size_t count) noexcept {
+			if constexpr (HasLane<T>) {
+#if defined(MARIGOLD_SIMD_X86)
+				using Lane = LaneType<T>;
+				const Lane* Left = reinterpret_cast<const Lane*>(lhs);
+				const Lane* Right = reinterpret_cast<const Lane*>(rhs);
+				switch (level()) {
+				case SimdLevel::AVX512: return Avx512::equal(Left, Right, count);
+				case SimdLevel::AVX2: return Avx2::equal(Left, Right, count);
+				case SimdLevel::SSE2: return Sse2::equal(Left, Right, count);
+				default: break;
+				}
+#endif
+			}
+
+			return std::equal(lhs, lhs + count, rhs);
+		}
+
+		template<class T>
+		inline std::size_t remove(T* first, const std::size_t count, const T& value) noexcept {
+			//Moves the elements not equal to value to the front in their order and returns how many there are.
+			if constexpr (HasLane<T>) {
+#if defined(MARIGOLD_SIMD_X86)
+				using Lane = LaneType<T>;
+				Lane* Data = reinterpret_cast<Lane*>(first);
+				const Lane Needle = std::bit_cast<Lane>(value);
+				switch (level()) {
+				case SimdLevel::AVX512: return Avx512::remove(Data, count, Needle);
+				case SimdLevel::AVX2: return Avx2::remove(Data, count, Needle);
+				case SimdLevel::SSE2: return Sse2::remove(Data, count, Needle);
+				default: break;
+				}
+#endif
+			}
+
+			return static_cast<std::size_t>(std::remove(first, first + count, value) - first);
+		}
+
+		inline void unpack(const std::uint32_t* words, const unsigned width, std::uint32_t* out) noexcept {
+			//Decodes all PACKED_BLOCK values of a block written by pack.
+			if (width == 0) {
+				std::fill_n(out, PACKED_BLOCK, 0u);
+				return;
+			}
+
+#if defined(MARIGOLD_SIMD_X86)
+			if (level() != SimdLevel::SCALAR) {
+				Sse2::unpack(words, width, out);
+				return;
+			}
+#endif
+
+			for (std::size_t i = 0; i < PACKED_BLOCK; i++)
+				out[i] = unpack_one(words, width, i);
+		}
+	}
+}
+
+#endif // !SIMD_H
@@ -0,0 +1,160 @@
+//Included by Simd.h once per instruction set, inside that set's namespace and target region.
+//Expects Ops<Lane> to provide LANES, Register, load, broadcast, equal_mask, add, min, max and store.
+//compress(value, keep), packing the kept lanes to the bottom, is optional and used by remove when present.
+
+template<class Lane>
+inline const Lane* find(const Lane* first, const std::size_t count, const Lane value) noexcept {
+	using Operations = Ops<Lane>;
+	const typename Operations::Register Needle = Operations::broadcast(value);
+
+	std::size_t Index = 0;
+	for (; Index + Operations::LANES <= count; Index += Operations::LANES) {
+		const std::uint64_t Mask = Operations::equal_mask(Operations::load(first + Index), Needle);
+		if (Mask)
+			return first + Index + std::countr_zero(Mask);
+	}
+	for (; Index < count; Index++) {
+		if (first[Index] == value)
+			return first + Index;
+	}
+
+	return first + count;
+}
+
+template<class Lane>
+inline std::size_t count(const Lane* first, const std::size_t count, const Lane value) noexcept {
+	using Operations = Ops<Lane>;
+	const typename Operations::Register Needle = Operations::broadcast(value);
+
+	std::size_t Matches = 0;
+	std::size_t Index = 0;
+	for (; Index + Operations::LANES <= count; Index += Operations::LANES)
+		Matches += std::popcount(Operations::equal_mask(Operations::load(first + Index), Needle));
+	for (; Index < count; Index++)
+		Matches += first[Index] == value;
+
+	return Matches;
+}
+
+template<class Lane>
+inline Lane sum(const Lane* first, const std::size_t count) noexcept {
+	using Operations = Ops<Lane>;
+	typename Operations::Register Total = Operations::broadcast(Lane(0));
+
+	std::size_t Index = 0;
+	for (; Index + Operations::LANES <= count; Index += Operations::LANES)
+		Total = Operations::add(Total, Operations::load(first + Index));
+
+	Lane Lanes[Operations::LANES];
+	Operations::store(Lanes, Total);
+
+	//Integer lanes wrap like the vector adds, the reduction runs unsigned so it cannot overflow.
+	using Accumulator = typename std::conditional_t<std::is_integral_v<Lane>, std::make_unsigned<Lane>, std::type_identity<Lane>>::type;
+	Accumulator Result = Accumulator(0);
+	for (std::size_t i = 0; i < Operations::LANES; i++)
+		Result += static_cast<Accumulator>(Lanes[i]);
+	for (; Index < count; Index++)
+		Result += static_cast<Accumulator>(first[Index]);
+
+	return static_cast<Lane>(Result);
+}
+
+template<class Lane>
+inline Lane minimum(const Lane* first, const std::size_t count) noexcept {
+	//Expects count > 0.
+	using Operations = Ops<Lane>;
+	Lane Result = first[0];
+	std::size_t Index = 0;
+	if (count >= Operations::LANES) {
+		typename Operations::Register Smallest = Operations::load(first);
+		for (Index = Operations::LANES; Index + Operations::LANES <= count; Index += Operations::LANES)
+			Smallest = Operations::min(Smallest, Operations::load(first + Index));
+
+		Lane Lanes[Operations::LANES];
+		Operations::store(Lanes, Smallest);
+		for (std::size_t i = 0; i < Operations::LANES; i++)
+			Result = Lanes[i] < Result ? Lanes[i] : Result;
+	}
+	for (; Index < count; Index++)
+		Result = first[Index] < Result ? first[Index] : Result;
+
+	return Result;
+}
+
+template<class Lane>
+inline Lane maximum(const Lane* first, const std::size_t count) noexcept {
+	//Expects count > 0.
+	using Operations = Ops<Lane>;
+	Lane Result = first[0];
+	std::size_t Index = 0;
+	if (count >= Operations::LANES) {
+		typename Operations::Register Largest = Operations::load(first);
+		for (Index = Operations::LANES; Index + Operations::LANES <= count; Index += Operations::LANES)
+			Largest = Operations::max(Largest, Operations::load(first + Index));
+
+		Lane Lanes[Operations::LANES];
+		Operations::store(Lanes, Largest);
+		for (std::size_t i = 0; i < Operations::LANES; i++)
+			Result = Lanes[i] > Result ? Lanes[i] : Result;
+	}
+	for (; Index < count; Index++)
+		Result = first[Index] > Result ? first[Index] : Result;
+
+	return Result;
+}
+
+template<class Lane>
+inline bool equal(const Lane* lhs, const Lane* rhs, const std::size_t count) noexcept {
+	using Operations = Ops<Lane>;
+	constexpr std::uint64_t AllLanes = (std::uint64_t(1) << Operations::LANES) - 1;
+
+	std::size_t Index = 0;
+	for (; Index + Operations::LANES <= count; Index += Operations::LANES) {
+		if (Operations::equal_mask(Operations::load(lhs + Index), Operations::load(rhs + Index)) != AllLanes)
+			return false;
+	}
+	for (; Index < count; Index++) {
+		if (!(lhs[Index] == rhs[Index]))
+			return false;
+	}
+
+	return true;
+}
+
+template<class Lane>
+inline std::size_t remove(Lane* first, const std::size_t count, const Lane value) noexcept {
+	//Writes never pass the block being read, so whole registers can be stored at the write position.
+	using Operations = Ops<Lane>;
+	constexpr std::uint64_t AllLanes = (std::uint64_t(1) << Operations::LANES) - 1;
+	const typename Operations::Register Needle = Operations::broadcast(value);
+
+	std::size_t Written = 0;
+	std::size_t Index = 0;
+	for (; Index + Operations::LANES <= count; Index += Operations::LANES) {
+		const typename Operations::Register Block = Operations::load(first + Index);
+		const std::uint64_t Keep = ~Operations::equal_mask(Block, Needle) & AllLanes;
+		if (Keep == AllLanes) {
+			if (Written != Index)
+				Operations::store(first + Written, Block);
+		}
+		else if constexpr (requires { Operations::compress(Block, Keep); })
+			Operations::store(first + Written, Operations::compress(Block, Keep));
+		else if (Keep) {
+			Lane Lanes[Operations::LANES];
+			Operations::store(Lanes, Block);
+			std::size_t Packed = Written;
+			for (std::size_t i = 0; i < Operations::LANES; i++) {
+				first[Packed] = Lanes[i];
+				Packed += (Keep >> i) & 1;
+			}
+		}
+		Written += std::popcount(Keep);
+	}
+	for (; Index < count; Index++) {
+		const Lane Value = first[Index];
+		first[Written] = Value;
+		Written += !(Value == value);
+	}
+
+	return Written;
+}
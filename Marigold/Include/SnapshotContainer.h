@@ -0,0 +1,472 @@
+#include "Container.h"
+#include "SegmentedContainer.h"
+#include <cstddef>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+
+#ifndef SNAPSHOT_CONTAINER_H
+#define SNAPSHOT_CONTAINER_H
+
+
+namespace Marigold {
+
+	//Read-mostly sequence shared between threads. Every published state is an immutable version, a directory of
+	//reference counted chunks of ChunkSize elements. Readers take a snapshot of the current version in O(1) without
+	//locking and keep reading it for as long as they hold it, whatever writers publish meanwhile.
+	//Writers are serialized. update() hands the writer an Editor over the current version that copies a chunk only
+	//when it is first written, so unchanged chunks are shared between versions, and publishes the result with one
+	//atomic store. A replaced version is reclaimed through the allocator once its last snapshot is gone.
+	template<
+		class T,
+		class Alloc = CustomAllocator<T>,
+		std::size_t ChunkSize = DEFAULT_SEGMENT_SIZE<T>
+	>
+	class SnapshotContainer final {
+	public:
+		using Type = T;
+		using Allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<unsigned char>;
+		using SizeType = std::size_t;
+		using ConstantPointer = const T*;
+		using Reference = T&;
+		using ConstantReference = const T&;
+		using DifferenceType = std::ptrdiff_t;
+		using AllocatorTraits = std::allocator_traits<Allocator>;
+
+		static constexpr SizeType CHUNK_SIZE = ChunkSize;
+
+		static_assert(std::is_object_v<T>, "The C++ Standard forbids containers of non-object types "
+			"because of [container.requirements].");
+		static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize has to be a power of two.");
+		static_assert(alignof(T) <= alignof(std::max_align_t), "Chunks are allocated as bytes and only guarantee fundamental alignment.");
+
+	private:
+		static constexpr SizeType CHUNK_SHIFT = std::countr_zero(ChunkSize);
+		static constexpr SizeType CHUNK_MASK = ChunkSize - 1;
+
+		struct Chunk {
+			std::atomic<SizeType> m_References{ 1 };
+			SizeType m_Size = 0;
+		};
+		struct Version {
+			std::atomic<SizeType> m_References{ 1 };
+			SizeType m_Size = 0;
+			SizeType m_Generation = 0;
+			SizeType m_ChunkCount = 0;
+			Allocator m_Allocator;
+		};
+
+		//Elements follow the chunk header, chunk pointers follow the version header.
+		static constexpr SizeType CHUNK_HEADER = (sizeof(Chunk) + alignof(T) - 1) & ~(alignof(T) - 1);
+		static constexpr SizeType CHUNK_BYTES = CHUNK_HEADER + ChunkSize * sizeof(T);
+		static constexpr SizeType VERSION_HEADER = (sizeof(Version) + alignof(Chunk*) - 1) & ~(alignof(Chunk*) - 1);
+
+		using Directory = Container<Chunk*, typename AllocatorTraits::template rebind_alloc<Chunk*>>;
+
+	public:
+		//A version held alive for reading. Copying one is a reference count increment.
+		class Snapshot final {
+		public:
+			class Iterator {
+			public:
+				using iterator_concept = std::random_access_iterator_tag;
+				using iterator_category = std::random_access_iterator_tag;
+				using value_type = Type;
+				using difference_type = DifferenceType;
+				using pointer = ConstantPointer;
+				using reference = ConstantReference;
+
+			public:
+				Iterator() noexcept = default;
+				Iterator(const Version* version, const difference_type index) noexcept
+					: m_Version(version), m_Index(index)
+				{
+				}
+
+				inline reference operator*() const noexcept { return element(m_Version, static_cast<SizeType>(m_Index)); }
+				inline pointer operator->() const noexcept { return std::addressof(**this); }
+				inline reference operator[](const difference_type offset) const noexcept { return *(*this + offset); }
+
+				inline Iterator& operator++() noexcept { ++m_Index; return *this; }
+				inline Iterator operator++(int) noexcept { Iterator Previous = *this; ++m_Index; return Previous; }
+				inline Iterator& operator--() noexcept { --m_Index; return *this; }
+				inline Iterator operator--(int) noexcept { Iterator Previous = *this; --m_Index; return Previous; }
+
+				inline Iterator& operator+=(const difference_type offset) noexcept { m_Index += offset; return *this; }
+				inline Iterator& operator-=(const difference_type offset) noexcept { m_Index -= offset; return *this; }
+
+				friend inline Iterator operator+(Iterator iterator, const difference_type offset) noexcept { return iterator += offset; }
+				friend inline Iterator operator+(const difference_type offset, Iterator iterator) noexcept { return iterator += offset; }
+				friend inline Iterator operator-(Iterator iterator, const difference_type offset) noexcept { return iterator -= offset; }
+				friend inline difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.m_Index - rhs.m_Index; }
+
+				inline bool operator==(const Iterator& other) const noexcept { return m_Index == other.m_Index; }
+				inline auto operator<=>(const Iterator& other) const noexcept { return m_Index <=> other.m_Index; }
+
+			private:
+				const Version* m_Version = nullptr;
+				difference_type m_Index = 0;
+			};
+			using ConstantIterator = Iterator;
+
+		public:
+			Snapshot() noexcept = default;
+			Snapshot(const Snapshot& other) noexcept
+				: m_Version(other.m_Version)
+			{
+				if (m_Version)
+					m_Version->m_References.fetch_add(1, std::memory_order_relaxed);
+			}
+			Snapshot(Snapshot&& other) noexcept
+				: m_Version(std::exchange(other.m_Version, nullptr))
+			{
+			}
+			Snapshot& operator=(Snapshot other) noexcept {
+				std::swap(m_Version, other.m_Version);
+				return *this;
+			}
+			~Snapshot() {
+				if (m_Version)
+					release_version(m_Version);
+			}
+
+			inline ConstantReference operator[](SizeType index) const noexcept {
+				assert(index < size() && "Index out of range");
+				return element(m_Version, index);
+			}
+			inline ConstantReference at(SizeType index) const {
+				if (index >= size())
+					throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+				return element(m_Version, index);
+			}
+			inline ConstantReference front() const noexcept { return (*this)[0]; }
+			inline ConstantReference back() const noexcept { return (*this)[size() - 1]; }
+
+			inline Iterator begin() const noexcept { return Iterator(m_Version, 0); }
+			inline Iterator cbegin() const noexcept { return begin(); }
+			inline Iterator end() const noexcept { return Iterator(m_Version, static_cast<DifferenceType>(size())); }
+			inline Iterator cend() const noexcept { return end(); }
+
+			inline SizeType size() const noexcept { return m_Version ? m_Version->m_Size : 0; }
+			inline bool empty() const noexcept { return size() == 0; }
+			//Counts publications, a later snapshot of the same container has a larger generation.
+			inline SizeType generation() const noexcept { return m_Version ? m_Version->m_Generation : 0; }
+
+		private:
+			friend class SnapshotContainer;
+
+			//Takes over a reference the caller already holds.
+			explicit Snapshot(Version* version) noexcept
+				: m_Version(version)
+			{
+			}
+
+			Version* m_Version = nullptr;
+		};
+
+		//Writable view of the next version, only handed out inside update(). Starts out sharing every chunk of the
+		//current version, a chunk is copied the first time it is written unless nothing else references it.
+		class Editor final {
+		public:
+			Editor(const Editor&) = delete;
+			Editor& operator=(const Editor&) = delete;
+			~Editor() {
+				clear();
+			}
+
+			inline ConstantReference operator[](SizeType index) const noexcept {
+				assert(index < m_Size && "Index out of range");
+				return elements(m_Chunks[index >> CHUNK_SHIFT])[index & CHUNK_MASK];
+			}
+			inline ConstantReference at(SizeType index) const {
+				if (index >= m_Size)
+					throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+				return (*this)[index];
+			}
+			//Writable element, copies its chunk first if a published version still uses it.
+			inline Reference modify(SizeType index) {
+				assert(index < m_Size && "Index out of range");
+				Chunk*& Target = m_Chunks[index >> CHUNK_SHIFT];
+				make_unique(Target);
+				return elements(Target)[index & CHUNK_MASK];
+			}
+
+			inline void push_back(ConstantReference value) { emplace_back(value); }
+			inline void push_back(Type&& value) { emplace_back(std::move(value)); }
+			template<class... args>
+			inline Reference emplace_back(args&&... arguments) {
+				//The arguments may refer to elements, the chunks they live in stay alive until the end.
+				if ((m_Size & CHUNK_MASK) == 0) {
+					Chunk* Fresh = m_Owner->allocate_chunk();
+					try {
+						m_Chunks.push_back(Fresh);
+					}
+					catch (...) {
+						m_Owner->deallocate_chunk(Fresh);
+						throw;
+					}
+				}
+				else
+					make_unique(m_Chunks.back());
+
+				Chunk* Last = m_Chunks.back();
+				try {
+					std::construct_at(elements(Last) + Last->m_Size, std::forward<args>(arguments)...);
+				}
+				catch (...) {
+					if (Last->m_Size == 0) {
+						m_Chunks.pop_back();
+						m_Owner->deallocate_chunk(Last);
+					}
+					throw;
+				}
+
+				m_Size++;
+				return elements(Last)[Last->m_Size++];
+			}
+			template<std::ranges::input_range Range>
+			inline void append_range(Range&& range) {
+				for (auto&& Value : range)
+					emplace_back(std::forward<decltype(Value)>(Value));
+			}
+
+			inline void pop_back() {
+				if (m_Size == 0)
+					return;
+
+				make_unique(m_Chunks.back());
+				Chunk* Last = m_Chunks.back();
+				std::destroy_at(elements(Last) + --Last->m_Size);
+				if (Last->m_Size == 0) {
+					m_Chunks.pop_back();
+					m_Owner->deallocate_chunk(Last);
+				}
+				m_Size--;
+			}
+			inline void clear() noexcept {
+				for (Chunk* Shared : m_Chunks)
+					release_chunk(Shared, m_Owner->m_Allocator);
+				m_Chunks.clear();
+				m_Size = 0;
+			}
+
+			inline SizeType size() const noexcept { return m_Size; }
+			inline bool empty() const noexcept { return m_Size == 0; }
+
+		private:
+			friend class SnapshotContainer;
+
+			Editor(SnapshotContainer& owner, const Version* base)
+				: m_Owner(&owner), m_Chunks(typename Directory::Allocator(owner.m_Allocator))
+			{
+				if (!base)
+					return;
+
+				m_Chunks.reserve(base->m_ChunkCount);
+				for (SizeType i = 0; i < base->m_ChunkCount; i++) {
+					Chunk* Shared = chunks(base)[i];
+					Shared->m_References.fetch_add(1, std::memory_order_relaxed);
+					m_Chunks.push_back(Shared);
+				}
+				m_Size = base->m_Size;
+			}
+
+			inline void make_unique(Chunk*& chunk) {
+				//A count of one is the editor's own reference, no version can be reading the chunk.
+				if (chunk->m_References.load(std::memory_order_acquire) == 1)
+					return;
+
+				Chunk* Copy = m_Owner->clone_chunk(chunk);
+				release_chunk(chunk, m_Owner->m_Allocator);
+				chunk = Copy;
+			}
+
+		private:
+			SnapshotContainer* m_Owner;
+			Directory m_Chunks;
+			SizeType m_Size = 0;
+		};
+
+		using Iterator = typename Snapshot::Iterator;
+		using ConstantIterator = Iterator;
+
+	public: //Special member functions
+		SnapshotContainer() noexcept(noexcept(Allocator())) {}
+		explicit SnapshotContainer(const Alloc& allocator) noexcept
+			: m_Allocator(allocator)
+		{
+		}
+		SnapshotContainer(std::initializer_list<Type> list, const Alloc& allocator = Alloc())
+			: SnapshotContainer(allocator)
+		{
+			assign_range(list);
+		}
+
+		//Readers hold the address of the container while taking a snapshot, so it is neither copied nor moved.
+		SnapshotContainer(const SnapshotContainer&) = delete;
+		SnapshotContainer& operator=(const SnapshotContainer&) = delete;
+
+		~SnapshotContainer() {
+			//Outstanding snapshots keep their versions, only the container's own reference is dropped.
+			Version* Current = m_Current.load(std::memory_order_acquire);
+			if (Current)
+				release_version(Current);
+		}
+
+	public: //Reading
+		inline Snapshot snapshot() const noexcept {
+			//The reader is counted under the current epoch while it loads the version and takes its reference,
+			//a writer replacing that version waits for both epoch counters to drain before dropping its own.
+			std::atomic<SizeType>& Readers = m_Readers[m_Epoch.load() & 1];
+			Readers.fetch_add(1);
+			Version* Current = m_Current.load();
+			if (Current)
+				Current->m_References.fetch_add(1, std::memory_order_relaxed);
+			Readers.fetch_sub(1);
+			return Snapshot(Current);
+		}
+
+	public: //Writing
+		//Runs function(Editor&) on the current version and publishes the result. Writers are serialized, readers are
+		//never blocked. If function throws nothing is published.
+		template<class Function>
+		Snapshot update(Function function) {
+			std::lock_guard<std::mutex> Guard(m_WriterLock);
+			Version* Base = m_Current.load(std::memory_order_acquire);
+			Editor Edit(*this, Base);
+			function(Edit);
+
+			Version* Next = build_version(Edit, Base ? Base->m_Generation + 1 : 1);
+			Next->m_References.fetch_add(1, std::memory_order_relaxed); //The snapshot returned to the writer.
+			m_Current.store(Next);
+			if (Base)
+				retire(Base);
+
+			return Snapshot(Next);
+		}
+		template<std::ranges::input_range Range>
+		inline Snapshot assign_range(Range&& range) {
+			return update([&range](Editor& edit) {
+				edit.clear();
+				edit.append_range(std::forward<Range>(range));
+			});
+		}
+		inline Snapshot clear() {
+			return update([](Editor& edit) { edit.clear(); });
+		}
+
+	public: //Capacity
+		inline SizeType size() const noexcept { return snapshot().size(); }
+		inline bool empty() const noexcept { return size() == 0; }
+		constexpr inline SizeType max_size() const noexcept { return std::numeric_limits<SizeType>::max() / sizeof(Type); }
+		inline Allocator get_allocator() const noexcept { return m_Allocator; }
+
+	private: //Chunks
+		static inline Type* elements(Chunk* chunk) noexcept {
+			return std::launder(reinterpret_cast<Type*>(reinterpret_cast<unsigned char*>(chunk) + CHUNK_HEADER));
+		}
+		static inline Chunk** chunks(const Version* version) noexcept {
+			return std::launder(reinterpret_cast<Chunk**>(reinterpret_cast<unsigned char*>(const_cast<Version*>(version)) + VERSION_HEADER));
+		}
+		static inline ConstantReference element(const Version* version, const SizeType index) noexcept {
+			return elements(chunks(version)[index >> CHUNK_SHIFT])[index & CHUNK_MASK];
+		}
+
+		inline Chunk* allocate_chunk() {
+			unsigned char* Block = AllocatorTraits::allocate(m_Allocator, CHUNK_BYTES);
+			if (!Block)
+				throw std::bad_alloc();
+
+			return ::new (static_cast<void*>(Block)) Chunk();
+		}
+		inline void deallocate_chunk(Chunk* chunk) noexcept {
+			std::destroy_at(chunk);
+			AllocatorTraits::deallocate(m_Allocator, reinterpret_cast<unsigned char*>(chunk), CHUNK_BYTES);
+		}
+		inline Chunk* clone_chunk(Chunk* source) {
+			Chunk* Copy = allocate_chunk();
+			try {
+				std::uninitialized_copy_n(elements(source), source->m_Size, elements(Copy));
+			}
+			catch (...) {
+				deallocate_chunk(Copy);
+				throw;
+			}
+
+			Copy->m_Size = source->m_Size;
+			return Copy;
+		}
+		static inline void release_chunk(Chunk* chunk, Allocator& allocator) noexcept {
+			if (chunk->m_References.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return;
+
+			std::destroy_n(elements(chunk), chunk->m_Size);
+			std::destroy_at(chunk);
+			AllocatorTraits::deallocate(allocator, reinterpret_cast<unsigned char*>(chunk), CHUNK_BYTES);
+		}
+
+	private: //Versions
+		inline Version* build_version(Editor& edit, const SizeType generation) {
+			//The editor's chunk references move into the version.
+			const SizeType ChunkCount = edit.m_Chunks.size();
+			const SizeType Bytes = VERSION_HEADER + ChunkCount * sizeof(Chunk*);
+			unsigned char* Block = AllocatorTraits::allocate(m_Allocator, Bytes);
+			if (!Block)
+				throw std::bad_alloc();
+
+			Version* Result = ::new (static_cast<void*>(Block)) Version{ {1}, edit.m_Size, generation, ChunkCount, m_Allocator };
+			std::uninitialized_copy_n(edit.m_Chunks.begin(), ChunkCount, reinterpret_cast<Chunk**>(Block + VERSION_HEADER));
+
+			edit.m_Chunks.clear();
+			edit.m_Size = 0;
+			return Result;
+		}
+		static inline void release_version(Version* version) noexcept {
+			if (version->m_References.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return;
+
+			Allocator Local(version->m_Allocator);
+			for (SizeType i = 0; i < version->m_ChunkCount; i++)
+				release_chunk(chunks(version)[i], Local);
+
+			const SizeType Bytes = VERSION_HEADER + version->m_ChunkCount * sizeof(Chunk*);
+			std::destroy_at(version);
+			AllocatorTraits::deallocate(Local, reinterpret_cast<unsigned char*>(version), Bytes);
+		}
+		inline void retire(Version* old) noexcept {
+			//Grace period, called after the new version is stored. A reader can only still be about to reference old
+			//if it is counted in one of the two epoch counters. Each round moves new readers to the other counter and
+			//waits for the one they left to drain, so a steady stream of readers cannot hold the writer up.
+			//All of these operations are sequentially consistent, a reader missed by the check loads the new version.
+			for (SizeType Round = 0; Round < 2; Round++) {
+				const SizeType Epoch = m_Epoch.fetch_add(1);
+				while (m_Readers[Epoch & 1].load() != 0)
+					std::this_thread::yield();
+			}
+
+			release_version(old);
+		}
+
+	private:
+		std::atomic<Version*> m_Current{ nullptr };
+		alignas(64) std::atomic<SizeType> m_Epoch{ 0 };
+		alignas(64) mutable std::atomic<SizeType> m_Readers[2]{};
+		std::mutex m_WriterLock;
+		Allocator m_Allocator;
+	};
+}
+
+#endif // !SNAPSHOT_CONTAINER_H
@@ -0,0 +1,546 @@
+#include "Container.h"
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+#ifndef SOA_CONTAINER_H
+#define SOA_CONTAINER_H
+
+
+namespace Marigold {
+
+	//Every column starts on a boundary of at least this many bytes, so column scans begin on a cache line.
+	inline constexpr std::size_t SOA_COLUMN_ALIGNMENT = 64;
+
+	//Structure of arrays, field i of every row is stored contiguously in column i. All columns share one block
+	//of Alloc rebound to bytes, so growth is a single allocation. Rows are handed out as tuples of references,
+	//columns as spans, the iterator zips the columns back together.
+	template<class Alloc, class... Ts>
+	class BasicSoAContainer final {
+	public:
+		using ValueType = std::tuple<Ts...>;
+		using Allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<unsigned char>;
+		using SizeType = std::size_t;
+		using Reference = std::tuple<Ts&...>;
+		using ConstantReference = std::tuple<const Ts&...>;
+		using DifferenceType = std::ptrdiff_t;
+		using AllocatorTraits = std::allocator_traits<Allocator>;
+
+		template<std::size_t Column>
+		using ColumnType = std::tuple_element_t<Column, ValueType>;
+
+		static constexpr SizeType COLUMNS = sizeof...(Ts);
+
+		static_assert(COLUMNS > 0, "A structure of arrays needs at least one column.");
+		static_assert((std::is_object_v<Ts> && ...), "The C++ Standard forbids containers of non-object types "
+			"because of [container.requirements].");
+
+	private:
+		using Columns = std::tuple<Ts*...>;
+		using Indices = std::index_sequence_for<Ts...>;
+
+		static constexpr std::array<SizeType, COLUMNS> SIZES = { sizeof(Ts)... };
+		static constexpr std::array<SizeType, COLUMNS> ALIGNMENTS = { (alignof(Ts) > SOA_COLUMN_ALIGNMENT ? alignof(Ts) : SOA_COLUMN_ALIGNMENT)... };
+		static constexpr SizeType ROW_SIZE = (sizeof(Ts) + ...);
+		//The allocator only promises its own alignment, the block is aligned by hand to the strictest column.
+		static constexpr SizeType BLOCK_ALIGNMENT = *std::max_element(ALIGNMENTS.begin(), ALIGNMENTS.end());
+
+		//Holds the column bases and a row index, dereferencing yields the row as a tuple of references.
+		template<bool IsConstant>
+		class BasicIterator {
+		public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::input_iterator_tag; //References are proxies.
+			using value_type = ValueType;
+			using difference_type = DifferenceType;
+			using reference = std::conditional_t<IsConstant, ConstantReference, Reference>;
+
+		public:
+			BasicIterator() noexcept = default;
+			BasicIterator(const Columns& columns, const difference_type index) noexcept
+				: m_Columns(columns), m_Index(index)
+			{
+			}
+			template<bool OtherConstant> requires (IsConstant && !OtherConstant)
+			BasicIterator(const BasicIterator<OtherConstant>& other) noexcept
+				: m_Columns(other.m_Columns), m_Index(other.m_Index)
+			{
+			}
+
+			inline reference operator*() const noexcept {
+				return std::apply([this](auto*... columns) { return reference(columns[m_Index]...); }, m_Columns);
+			}
+			inline reference operator[](const difference_type offset) const noexcept { return *(*this + offset); }
+
+			inline BasicIterator& operator++() noexcept { ++m_Index; return *this; }
+			inline BasicIterator operator++(int) noexcept { BasicIterator Previous = *this; ++m_Index; return Previous; }
+			inline BasicIterator& operator--() noexcept { --m_Index; return *this; }
+			inline BasicIterator operator--(int) noexcept { BasicIterator Previous = *this; --m_Index; return Previous; }
+
+			inline BasicIterator& operator+=(const difference_type offset) noexcept { m_Index += offset; return *this; }
+			inline BasicIterator& operator-=(const difference_type offset) noexcept { m_Index -= offset; return *this; }
+
+			friend inline BasicIterator operator+(BasicIterator iterator, const difference_type offset) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator+(const difference_type offset, BasicIterator iterator) noexcept { return iterator += offset; }
+			friend inline BasicIterator operator-(BasicIterator iterator, const difference_type offset) noexcept { return iterator -= offset; }
+			friend inline difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept { return lhs.m_Index - rhs.m_Index; }
+
+			inline bool operator==(const BasicIterator& other) const noexcept { return m_Index == other.m_Index; }
+			inline auto operator<=>(const BasicIterator& other) const noexcept { return m_Index <=> other.m_Index; }
+
+		private:
+			template<bool> friend class BasicIterator;
+
+			Columns m_Columns{};
+			difference_type m_Index = 0;
+		};
+
+	public:
+		using Iterator = BasicIterator<false>;
+		using ConstantIterator = BasicIterator<true>;
+		using ReverseIterator = std::reverse_iterator<Iterator>;
+		using ReverseConstantIterator = std::reverse_iterator<ConstantIterator>;
+
+	public: //Special member functions
+		BasicSoAContainer() noexcept(noexcept(Allocator())) {}
+		explicit BasicSoAContainer(const Alloc& allocator) noexcept
+			: m_Allocator(allocator)
+		{
+		}
+
+		//Copy Semantics
+		BasicSoAContainer(const BasicSoAContainer& other)
+			: m_Allocator(AllocatorTraits::select_on_container_copy_construction(other.m_Allocator))
+		{
+			copy_from(other);
+		}
+		BasicSoAContainer& operator=(const BasicSoAContainer& other) {
+			if (this == &other)
+				return *this;
+
+			clear();
+			if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+				if (m_Allocator != other.m_Allocator) {
+					release();
+					m_Allocator = other.m_Allocator;
+				}
+			}
+
+			copy_from(other);
+			return *this;
+		}
+
+		//Move Semantics
+		BasicSoAContainer(BasicSoAContainer&& other) noexcept
+			: m_Allocator(std::move(other.m_Allocator))
+		{
+			steal(other);
+		}
+		BasicSoAContainer& operator=(BasicSoAContainer&& other) noexcept {
+			if (this == &other)
+				return *this;
+
+			clear();
+			if (AllocatorTraits::propagate_on_container_move_assignment::value || m_Allocator == other.m_Allocator) {
+				release();
+				if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value)
+					m_Allocator = std::move(other.m_Allocator);
+
+				steal(other);
+				return *this;
+			}
+
+			//Unequal allocators that do not propagate, the rows have to be moved one by one.
+			reserve(other.size());
+			for (SizeType i = 0; i < other.size(); i++)
+				std::apply([this](auto&... fields) { emplace_back(std::move(fields)...); }, other[i]);
+			other.clear();
+			return *this;
+		}
+
+		~BasicSoAContainer() {
+			clear();
+			release();
+		}
+
+	public: //Access
+		inline Reference at(SizeType index) {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return (*this)[index];
+		}
+		inline ConstantReference at(SizeType index) const {
+			if (index >= m_Size)
+				throw std::out_of_range("Access Violation - " + std::to_string(index));
+
+			return (*this)[index];
+		}
+
+		inline Reference operator[](SizeType index) noexcept {
+			assert(index < size() && "Index out of range");
+			return std::apply([index](auto*... columns) { return Reference(columns[index]...); }, m_Columns);
+		}
+		inline ConstantReference operator[](SizeType index) const noexcept {
+			assert(index < size() && "Index out of range");
+			return std::apply([index](auto*... columns) { return ConstantReference(columns[index]...); }, m_Columns);
+		}
+
+		inline Reference front() noexcept { return (*this)[0]; }
+		inline ConstantReference front() const noexcept { return (*this)[0]; }
+
+		inline Reference back() noexcept { return (*this)[m_Size - 1]; }
+		inline ConstantReference back() const noexcept { return (*this)[m_Size - 1]; }
+
+		//One field of every row as a contiguous, aligned array. Scanning a column streams only that field.
+		template<std::size_t Column>
+		inline std::span<ColumnType<Column>> column() noexcept { return { std::get<Column>(m_Columns), m_Size }; }
+		template<std::size_t Column>
+		inline std::span<const ColumnType<Column>> column() const noexcept { return { std::get<Column>(m_Columns), m_Size }; }
+
+		template<std::size_t Column>
+		inline ColumnType<Column>* data() noexcept { return std::get<Column>(m_Columns); }
+		template<std::size_t Column>
+		inline const ColumnType<Column>* data() const noexcept { return std::get<Column>(m_Columns); }
+
+	public: //Insertion
+		inline void push_back(const ValueType& row) {
+			std::apply([this](const Ts&... fields) { emplace_back(fields...); }, row);
+		}
+		inline void push_back(ValueType&& row) {
+			std::apply([this](Ts&... fields) { emplace_back(std::move(fields)...); }, row);
+		}
+
+		//Takes one constructor argument per column.
+		template<class... args> requires (sizeof...(args) == COLUMNS)
+		inline Reference emplace_back(args&&... arguments) {
+			if (m_Size == m_Capacity) {
+				//The row is built in the new block before the old one goes, the arguments may refer to existing rows.
+				const SizeType NewCapacity = grow_capacity(m_Size + 1);
+				Columns NewColumns = allocate_block(NewCapacity);
+				try {
+					construct_row(NewColumns, m_Size, std::forward<args>(arguments)...);
+				}
+				catch (...) {
+					deallocate_block(NewColumns, NewCapacity);
+					throw;
+				}
+
+				try {
+					transfer(NewColumns);
+				}
+				catch (...) {
+					destroy_row(NewColumns, m_Size, COLUMNS);
+					deallocate_block(NewColumns, NewCapacity);
+					throw;
+				}
+				adopt(NewColumns, NewCapacity);
+			}
+			else
+				construct_row(m_Columns, m_Size, std::forward<args>(arguments)...);
+
+			return (*this)[m_Size++];
+		}
+
+	public: //Removal
+		inline void clear() noexcept {
+			shrink_size(0);
+		}
+		inline void pop_back() {
+			if (m_Size == 0)
+				return;
+
+			shrink_size(m_Size - 1);
+		}
+
+	public: //Iterators
+		inline Iterator begin() noexcept { return Iterator(m_Columns, 0); }
+		inline ConstantIterator begin() const noexcept { return ConstantIterator(m_Columns, 0); }
+		inline ConstantIterator cbegin() const noexcept { return begin(); }
+
+		inline Iterator end() noexcept { return Iterator(m_Columns, static_cast<DifferenceType>(m_Size)); }
+		inline ConstantIterator end() const noexcept { return ConstantIterator(m_Columns, static_cast<DifferenceType>(m_Size)); }
+		inline ConstantIterator cend() const noexcept { return end(); }
+
+		inline ReverseIterator rbegin() noexcept { return ReverseIterator(end()); }
+		inline ReverseConstantIterator rbegin() const noexcept { return ReverseConstantIterator(end()); }
+		inline ReverseConstantIterator crbegin() const noexcept { return rbegin(); }
+
+		inline ReverseIterator rend() noexcept { return ReverseIterator(begin()); }
+		inline ReverseConstantIterator rend() const noexcept { return ReverseConstantIterator(begin()); }
+		inline ReverseConstantIterator crend() const noexcept { return rend(); }
+
+	public: //Capacity
+		inline void reserve(SizeType capacity) {
+			if (capacity <= m_Capacity)
+				return;
+			if (capacity > max_size())
+				throw std::length_error("Max allowed container size exceeded!");
+
+			reallocate(capacity);
+		}
+		inline void shrink_to_fit() {
+			if (m_Size == m_Capacity)
+				return;
+
+			if (m_Size == 0)
+				release();
+			else
+				reallocate(m_Size);
+		}
+		inline void swap(BasicSoAContainer& other) noexcept {
+			if (this == &other)
+				return;
+
+			if constexpr (AllocatorTraits::propagate_on_container_swap::value || AllocatorTraits::is_always_equal::value)
+				std::swap(m_Allocator, other.m_Allocator);
+
+			std::swap(m_Columns, other.m_Columns);
+			std::swap(m_Size, other.m_Size);
+			std::swap(m_Capacity, other.m_Capacity);
+		}
+
+		void resize(SizeType count) {
+			if (count <= size()) {
+				shrink_size(count);
+				return;
+			}
+
+			reserve(count);
+			while (m_Size < count)
+				emplace_back(Ts()...);
+		}
+
+		inline Allocator get_allocator() const noexcept { return m_Allocator; }
+		constexpr inline SizeType max_size() const noexcept { return std::numeric_limits<SizeType>::max() / ROW_SIZE / REALLOCATION_FACTOR; }
+		inline SizeType capacity() const noexcept { return m_Capacity; }
+		inline SizeType size() const noexcept { return m_Size; }
+		inline bool empty() const noexcept { return m_Size == 0; }
+
+	private: //Memory
+		static constexpr inline std::array<SizeType, COLUMNS + 1> layout(const SizeType capacity) noexcept {
+			//Byte offset of every column in a block of capacity rows, the last entry is the size of the block.
+			std::array<SizeType, COLUMNS + 1> Result{};
+			SizeType Offset = 0;
+			for (SizeType i = 0; i < COLUMNS; i++) {
+				Offset = (Offset + ALIGNMENTS[i] - 1) & ~(ALIGNMENTS[i] - 1);
+				Result[i] = Offset;
+				Offset += SIZES[i] * capacity;
+			}
+
+			Result[COLUMNS] = Offset;
+			return Result;
+		}
+		static constexpr inline SizeType shift_offset(const SizeType capacity) noexcept {
+			//How far the block was moved up to align it is kept behind the last column, deallocation needs it back.
+			return (layout(capacity)[COLUMNS] + alignof(SizeType) - 1) & ~(alignof(SizeType) - 1);
+		}
+		static constexpr inline SizeType allocation_bytes(const SizeType capacity) noexcept {
+			return shift_offset(capacity) + sizeof(SizeType) + BLOCK_ALIGNMENT - 1;
+		}
+		inline SizeType grow_capacity(const SizeType required) const {
+			if (required > max_size())
+				throw std::length_error("Max allowed container size exceeded!");
+
+			const SizeType Grown = m_Capacity * REALLOCATION_FACTOR;
+			return Grown > required ? Grown : required;
+		}
+
+		inline Columns allocate_block(const SizeType capacity) {
+			const auto Layout = layout(capacity);
+			unsigned char* Allocation = AllocatorTraits::allocate(m_Allocator, allocation_bytes(capacity));
+			if (!Allocation)
+				throw std::bad_alloc();
+
+			const SizeType Shift = (BLOCK_ALIGNMENT - reinterpret_cast<std::uintptr_t>(Allocation) % BLOCK_ALIGNMENT) % BLOCK_ALIGNMENT;
+			unsigned char* Block = Allocation + Shift;
+			std::memcpy(Block + shift_offset(capacity), &Shift, sizeof(SizeType));
+
+			return [&]<std::size_t... Column>(std::index_sequence<Column...>) {
+				return Columns(reinterpret_cast<Ts*>(Block + Layout[Column])...);
+			}(Indices{});
+		}
+		inline void deallocate_block(const Columns& columns, const SizeType capacity) noexcept {
+			if (capacity == 0)
+				return;
+
+			//Column 0 sits at offset 0, its address is the aligned block.
+			unsigned char* Block = reinterpret_cast<unsigned char*>(std::get<0>(columns));
+			SizeType Shift = 0;
+			std::memcpy(&Shift, Block + shift_offset(capacity), sizeof(SizeType));
+			AllocatorTraits::deallocate(m_Allocator, Block - Shift, allocation_bytes(capacity));
+		}
+		inline void release() noexcept {
+			deallocate_block(m_Columns, m_Capacity);
+			m_Columns = Columns();
+			m_Capacity = 0;
+		}
+		inline void adopt(const Columns& columns, const SizeType capacity) noexcept {
+			//Only called once the rows live in columns, the old ones are already destroyed or relocated.
+			deallocate_block(m_Columns, m_Capacity);
+			m_Columns = columns;
+			m_Capacity = capacity;
+		}
+		inline void steal(BasicSoAContainer& other) noexcept {
+			m_Columns = std::exchange(other.m_Columns, Columns());
+			m_Size = std::exchange(other.m_Size, 0);
+			m_Capacity = std::exchange(other.m_Capacity, 0);
+		}
+
+		inline void reallocate(const SizeType capacity) {
+			Columns NewColumns = allocate_block(capacity);
+			try {
+				transfer(NewColumns);
+			}
+			catch (...) {
+				deallocate_block(NewColumns, capacity);
+				throw;
+			}
+			adopt(NewColumns, capacity);
+		}
+		inline void transfer(const Columns& target) {
+			//Moves every column into target and destroys the originals. Columns that cannot be moved without throwing
+			//are copied, and they go first: if a copy fails nothing has been moved yet, the copies already built are
+			//destroyed and the container is left as it was. Only a move-only column with a throwing move can fail after
+			//that, which leaves the moved columns valid but unspecified.
+			std::array<bool, COLUMNS> Built{};
+			try {
+				[&]<std::size_t... Column>(std::index_sequence<Column...>) {
+					(transfer_pass<Column, true>(target, Built), ...);
+					(transfer_pass<Column, false>(target, Built), ...);
+				}(Indices{});
+			}
+			catch (...) {
+				[&]<std::size_t... Column>(std::index_sequence<Column...>) {
+					(destroy_built<Column>(target, Built), ...);
+				}(Indices{});
+				throw;
+			}
+
+			[&]<std::size_t... Column>(std::index_sequence<Column...>) {
+				(destroy_relocated<Column>(), ...);
+			}(Indices{});
+		}
+		template<std::size_t Column>
+		static constexpr inline bool copies_column() noexcept {
+			using T = ColumnType<Column>;
+			return !IsTriviallyRelocatable<T>::value && !std::is_nothrow_move_constructible_v<T> && std::is_copy_constructible_v<T>;
+		}
+		template<std::size_t Column, bool Copies>
+		inline void transfer_pass(const Columns& target, std::array<bool, COLUMNS>& built) {
+			if constexpr (copies_column<Column>() == Copies) {
+				transfer_column<Column>(target);
+				built[Column] = true;
+			}
+		}
+		template<std::size_t Column>
+		inline void destroy_built(const Columns& target, const std::array<bool, COLUMNS>& built) noexcept {
+			//A memcpy'd column shares its resources with the original, only the original may destroy them.
+			if constexpr (!IsTriviallyRelocatable<ColumnType<Column>>::value) {
+				if (built[Column])
+					std::destroy_n(std::get<Column>(target), m_Size);
+			}
+		}
+		template<std::size_t Column>
+		inline void transfer_column(const Columns& target) {
+			using T = ColumnType<Column>;
+			T* Source = std::get<Column>(m_Columns);
+			T* Destination = std::get<Column>(target);
+			if (m_Size == 0)
+				return;
+
+			if constexpr (IsTriviallyRelocatable<T>::value)
+				std::memcpy(static_cast<void*>(Destination), static_cast<const void*>(Source), m_Size * sizeof(T));
+			else if constexpr (copies_column<Column>())
+				std::uninitialized_copy_n(Source, m_Size, Destination);
+			else
+				std::uninitialized_move_n(Source, m_Size, Destination);
+		}
+		template<std::size_t Column>
+		inline void destroy_relocated() noexcept {
+			//Trivially relocatable columns were memcpy'd, their sources are dead storage already.
+			using T = ColumnType<Column>;
+			if constexpr (!IsTriviallyRelocatable<T>::value)
+				std::destroy_n(std::get<Column>(m_Columns), m_Size);
+		}
+
+	private: //Rows
+		template<class... args>
+		inline void construct_row(const Columns& columns, const SizeType index, args&&... arguments) {
+			SizeType Constructed = 0;
+			try {
+				[&]<std::size_t... Column>(std::index_sequence<Column...>) {
+					((AllocatorTraits::construct(m_Allocator, std::get<Column>(columns) + index, std::forward<args>(arguments)), Constructed++), ...);
+				}(Indices{});
+			}
+			catch (...) {
+				destroy_row(columns, index, Constructed);
+				throw;
+			}
+		}
+		inline void destroy_row(const Columns& columns, const SizeType index, const SizeType count) noexcept {
+			//Destroys the first count fields of row index.
+			[&]<std::size_t... Column>(std::index_sequence<Column...>) {
+				((Column < count ? AllocatorTraits::destroy(m_Allocator, std::get<Column>(columns) + index) : void()), ...);
+			}(Indices{});
+		}
+		inline void shrink_size(const SizeType count) noexcept {
+			if constexpr (!(std::is_trivially_destructible_v<Ts> && ...)) {
+				for (SizeType i = m_Size; i > count; i--)
+					destroy_row(m_Columns, i - 1, COLUMNS);
+			}
+
+			m_Size = count;
+		}
+		inline void copy_from(const BasicSoAContainer& other) {
+			reserve(other.size());
+			for (SizeType i = 0; i < other.size(); i++)
+				std::apply([this](const Ts&... fields) { emplace_back(fields...); }, other[i]);
+		}
+
+	private:
+		Columns m_Columns{};
+		SizeType m_Size = 0;
+		SizeType m_Capacity = 0;
+		Allocator m_Allocator;
+	};
+
+	template<class... Ts>
+	using SoAContainer = BasicSoAContainer<CustomAllocator<unsigned char, SOA_COLUMN_ALIGNMENT>, Ts...>;
+
+
+	//Non-member functions
+	template<class Allocator, class... Ts>
+	inline void swap(BasicSoAContainer<Allocator, Ts...>& lhs, BasicSoAContainer<Allocator, Ts...>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+
+	//Operators
+	template<class Allocator, class... Ts>
+	bool operator==(const BasicSoAContainer<Allocator, Ts...>& lhs, const BasicSoAContainer<Allocator, Ts...>& rhs) {
+		if (lhs.size() != rhs.size())
+			return false;
+
+		//Column by column, each comparison is a linear scan of one array.
+		return [&]<std::size_t... Column>(std::index_sequence<Column...>) {
+			return (std::ranges::equal(lhs.template column<Column>(), rhs.template column<Column>()) && ...);
+		}(std::index_sequence_for<Ts...>{});
+	}
+}
+
+#endif // !SOA_CONTAINER_H
@@ -0,0 +1,218 @@
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+
+namespace Marigold {
+
+	//Bucket i of the size histogram counts allocations of [2^i, 2^(i + 1)) bytes.
+	inline constexpr std::size_t TELEMETRY_HISTOGRAM_BUCKETS = 64;
+	inline constexpr std::size_t TELEMETRY_SHARDS = 32;
+
+	//Point in time copy of an allocator's counters.
+	struct TelemetrySnapshot {
+		using size_type = std::size_t;
+
+		size_type m_Allocations = 0;
+		size_type m_Deallocations = 0;
+		size_type m_AllocatedMemory = 0;
+		size_type m_DeallocatedMemory = 0;
+		size_type m_Constructions = 0;
+		size_type m_Deconstructions = 0;
+		size_type m_LiveMemory = 0;
+		size_type m_PeakMemory = 0;
+		std::array<size_type, TELEMETRY_HISTOGRAM_BUCKETS> m_Histogram{};
+
+		inline void write_json(std::ostream& stream) const {
+			stream << "{\"allocations\":" << m_Allocations
+				<< ",\"deallocations\":" << m_Deallocations
+				<< ",\"allocated_bytes\":" << m_AllocatedMemory
+				<< ",\"deallocated_bytes\":" << m_DeallocatedMemory
+				<< ",\"constructions\":" << m_Constructions
+				<< ",\"destructions\":" << m_Deconstructions
+				<< ",\"live_bytes\":" << m_LiveMemory
+				<< ",\"peak_bytes\":" << m_PeakMemory
+				<< ",\"size_histogram\":[";
+			for (size_type i = 0; i < used_buckets(); i++)
+				stream << (i ? "," : "") << m_Histogram[i];
+			stream << "]}";
+		}
+		inline void write_prometheus(std::ostream& stream, const std::string_view prefix = "marigold_allocator") const {
+			//Text exposition format, the histogram buckets are cumulative as the format requires.
+			stream << prefix << "_allocations_total " << m_Allocations << '\n'
+				<< prefix << "_deallocations_total " << m_Deallocations << '\n'
+				<< prefix << "_allocated_bytes_total " << m_AllocatedMemory << '\n'
+				<< prefix << "_deallocated_bytes_total " << m_DeallocatedMemory << '\n'
+				<< prefix << "_constructions_total " << m_Constructions << '\n'
+				<< prefix << "_destructions_total " << m_Deconstructions << '\n'
+				<< prefix << "_live_bytes " << m_LiveMemory << '\n'
+				<< prefix << "_peak_bytes " << m_PeakMemory << '\n';
+
+			stream << "# TYPE " << prefix << "_allocation_size_bytes histogram\n";
+			size_type Cumulative = 0;
+			for (size_type i = 0; i < used_buckets(); i++) {
+				Cumulative += m_Histogram[i];
+				stream << prefix << "_allocation_size_bytes_bucket{le=\"" << ((size_type(2) << i) - 1) << "\"} " << Cumulative << '\n';
+			}
+			stream << prefix << "_allocation_size_bytes_bucket{le=\"+Inf\"} " << m_Allocations << '\n'
+				<< prefix << "_allocation_size_bytes_sum " << m_AllocatedMemory << '\n'
+				<< prefix << "_allocation_size_bytes_count " << m_Allocations << '\n';
+		}
+
+	private:
+		inline size_type used_buckets() const noexcept {
+			size_type Used = m_Histogram.size();
+			while (Used > 0 && m_Histogram[Used - 1] == 0)
+				Used--;
+			return Used;
+		}
+	};
+
+	//Telemetry policies receive every event of an allocator through static hooks.
+	template<class Policy>
+	concept IsTelemetryPolicy = requires(std::size_t size) {
+		{ Policy::ENABLED } -> std::convertible_to<bool>;
+		Policy::on_allocate(size);
+		Policy::on_deallocate(size);
+		Policy::on_construct();
+		Policy::on_destroy();
+		{ Policy::snapshot() } -> std::same_as<TelemetrySnapshot>;
+		Policy::reset();
+	};
+
+	//Compiles away entirely, snapshots are all zero.
+	struct NoTelemetry {
+		static constexpr bool ENABLED = false;
+
+		static constexpr inline void on_allocate(std::size_t) noexcept {}
+		static constexpr inline void on_deallocate(std::size_t) noexcept {}
+		static constexpr inline void on_construct() noexcept {}
+		static constexpr inline void on_destroy() noexcept {}
+
+		static inline TelemetrySnapshot snapshot() noexcept { return {}; }
+		static inline void reset() noexcept {}
+	};
+
+	//Process wide counters shared by every allocator using the same Tag, so copies and rebinds report together.
+	//Each thread increments its own cache line sized shard with relaxed atomics, shards are only summed by snapshot().
+	//Live and peak bytes are single counters, they are touched on allocation and deallocation only.
+	template<class Tag = void, std::size_t Shards = TELEMETRY_SHARDS>
+	class InstrumentedTelemetry final {
+	public:
+		using size_type = std::size_t;
+
+		static constexpr bool ENABLED = true;
+
+		static_assert(Shards > 0, "At least one shard is needed.");
+
+	private:
+		struct alignas(64) Shard {
+			std::atomic<size_type> m_Allocations{ 0 };
+			std::atomic<size_type> m_Deallocations{ 0 };
+			std::atomic<size_type> m_AllocatedMemory{ 0 };
+			std::atomic<size_type> m_DeallocatedMemory{ 0 };
+			std::atomic<size_type> m_Constructions{ 0 };
+			std::atomic<size_type> m_Deconstructions{ 0 };
+			std::array<std::atomic<size_type>, TELEMETRY_HISTOGRAM_BUCKETS> m_Histogram{};
+		};
+
+		struct Counters {
+			std::array<Shard, Shards> m_Shards;
+			alignas(64) std::atomic<size_type> m_LiveMemory{ 0 };
+			std::atomic<size_type> m_PeakMemory{ 0 };
+			std::atomic<size_type> m_NextShard{ 0 };
+		};
+
+	public:
+		static inline void on_allocate(const size_type size) noexcept {
+			Shard& Local = local_shard();
+			Local.m_Allocations.fetch_add(1, std::memory_order_relaxed);
+			Local.m_AllocatedMemory.fetch_add(size, std::memory_order_relaxed);
+			Local.m_Histogram[bucket(size)].fetch_add(1, std::memory_order_relaxed);
+
+			Counters& Shared = counters();
+			const size_type Live = Shared.m_LiveMemory.fetch_add(size, std::memory_order_relaxed) + size;
+			size_type Peak = Shared.m_PeakMemory.load(std::memory_order_relaxed);
+			while (Live > Peak && !Shared.m_PeakMemory.compare_exchange_weak(Peak, Live, std::memory_order_relaxed)) {}
+		}
+		static inline void on_deallocate(const size_type size) noexcept {
+			Shard& Local = local_shard();
+			Local.m_Deallocations.fetch_add(1, std::memory_order_relaxed);
+			Local.m_DeallocatedMemory.fetch_add(size, std::memory_order_relaxed);
+			counters().m_LiveMemory.fetch_sub(size, std::memory_order_relaxed);
+		}
+		static inline void on_construct() noexcept {
+			local_shard().m_Constructions.fetch_add(1, std::memory_order_relaxed);
+		}
+		static inline void on_destroy() noexcept {
+			local_shard().m_Deconstructions.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		static inline TelemetrySnapshot snapshot() noexcept {
+			//Shards are read one after another while other threads keep counting, totals are consistent per counter only.
+			Counters& Shared = counters();
+			TelemetrySnapshot Result;
+			for (const Shard& Current : Shared.m_Shards) {
+				Result.m_Allocations += Current.m_Allocations.load(std::memory_order_relaxed);
+				Result.m_Deallocations += Current.m_Deallocations.load(std::memory_order_relaxed);
+				Result.m_AllocatedMemory += Current.m_AllocatedMemory.load(std::memory_order_relaxed);
+				Result.m_DeallocatedMemory += Current.m_DeallocatedMemory.load(std::memory_order_relaxed);
+				Result.m_Constructions += Current.m_Constructions.load(std::memory_order_relaxed);
+				Result.m_Deconstructions += Current.m_Deconstructions.load(std::memory_order_relaxed);
+				for (size_type i = 0; i < TELEMETRY_HISTOGRAM_BUCKETS; i++)
+					Result.m_Histogram[i] += Current.m_Histogram[i].load(std::memory_order_relaxed);
+			}
+
+			Result.m_LiveMemory = Shared.m_LiveMemory.load(std::memory_order_relaxed);
+			Result.m_PeakMemory = Shared.m_PeakMemory.load(std::memory_order_relaxed);
+			return Result;
+		}
+		static inline void reset() noexcept {
+			//Clears the event counters, live bytes keep counting and the peak restarts from them.
+			Counters& Shared = counters();
+			for (Shard& Current : Shared.m_Shards) {
+				Current.m_Allocations.store(0, std::memory_order_relaxed);
+				Current.m_Deallocations.store(0, std::memory_order_relaxed);
+				Current.m_AllocatedMemory.store(0, std::memory_order_relaxed);
+				Current.m_DeallocatedMemory.store(0, std::memory_order_relaxed);
+				Current.m_Constructions.store(0, std::memory_order_relaxed);
+				Current.m_Deconstructions.store(0, std::memory_order_relaxed);
+				for (std::atomic<size_type>& Bucket : Current.m_Histogram)
+					Bucket.store(0, std::memory_order_relaxed);
+			}
+
+			Shared.m_PeakMemory.store(Shared.m_LiveMemory.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+
+	private:
+		static inline Counters& counters() noexcept {
+			static Counters Instance;
+			return Instance;
+		}
+		static inline Shard& local_shard() noexcept {
+			//Threads are dealt shards round robin on first use.
+			thread_local Shard& Local = counters().m_Shards[counters().m_NextShard.fetch_add(1, std::memory_order_relaxed) % Shards];
+			return Local;
+		}
+		static constexpr inline size_type bucket(const size_type size) noexcept {
+			return size == 0 ? 0 : static_cast<size_type>(std::bit_width(size)) - 1;
+		}
+	};
+
+	//Instrumented in debug builds or when MARIGOLD_TELEMETRY is defined, compiled out otherwise.
+#if defined(MARIGOLD_TELEMETRY) || !defined(NDEBUG)
+	using DefaultTelemetry = InstrumentedTelemetry<>;
+#else
+	using DefaultTelemetry = NoTelemetry;
+#endif
+}
+
+#endif // !TELEMETRY_H
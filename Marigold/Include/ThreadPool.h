@@ -0,0 +1,272 @@
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+
+namespace Marigold {
+
+	//Bulk operations on fewer elements than this stay on the calling thread, the hand off costs more than it saves.
+	inline constexpr std::size_t PARALLEL_THRESHOLD = 32 * 1024;
+	//Smallest number of elements a single task works on.
+	inline constexpr std::size_t PARALLEL_GRAIN = 4 * 1024;
+
+	//Work stealing pool. Every worker owns a deque, it pushes and pops at the back while idle workers steal from the front.
+	//Ranges are split lazily, a task halves itself and publishes the upper half until it is no larger than the grain,
+	//so busy workers keep the big pieces stealable and idle ones take them.
+	class ThreadPool final {
+	public:
+		using size_type = std::size_t;
+
+	private:
+		struct TaskGroup {
+			std::atomic<size_type> m_Pending{ 1 };
+			std::atomic<bool> m_Failed{ false };
+			std::mutex m_ErrorLock;
+			std::exception_ptr m_Error;
+		};
+
+		struct Task {
+			void (*m_Run)(const void*, size_type, size_type) = nullptr;
+			const void* m_Function = nullptr;
+			size_type m_Begin = 0;
+			size_type m_End = 0;
+			size_type m_Grain = 1;
+			TaskGroup* m_Group = nullptr;
+		};
+
+		struct alignas(64) WorkQueue {
+			std::mutex m_Lock;
+			std::deque<Task> m_Tasks;
+		};
+
+		struct WorkerIdentity {
+			ThreadPool* m_Pool = nullptr;
+			size_type m_Index = 0;
+		};
+
+	public:
+		explicit ThreadPool(const size_type workerCount = default_worker_count())
+			: m_Queues(std::make_unique<WorkQueue[]>(workerCount + 1)), m_WorkerCount(workerCount)
+		{
+			m_Workers.reserve(workerCount);
+			for (size_type i = 0; i < workerCount; i++)
+				m_Workers.emplace_back([this, i] { worker_loop(i); });
+		}
+		~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> Guard(m_SleepLock);
+				m_Stopping = true;
+			}
+			m_Wake.notify_all();
+
+			for (std::thread& Worker : m_Workers)
+				Worker.join();
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		static inline ThreadPool& instance() {
+			static ThreadPool Instance;
+			return Instance;
+		}
+		static inline size_type default_worker_count() noexcept {
+			//The calling thread works too, so one thread per core is left for it.
+			const size_type Cores = std::thread::hardware_concurrency();
+			return Cores > 1 ? Cores - 1 : 0;
+		}
+
+	public:
+		//Calls function(begin, end) on disjoint subranges covering [0, count) and returns once all of them finished.
+		//The calling thread runs tasks while it waits. The first exception thrown by function cancels the tasks that
+		//have not started yet and is rethrown here.
+		template<class Function>
+		void parallel_for(const size_type count, const size_type grain, Function&& function) {
+			if (count == 0)
+				return;
+
+			const size_type Grain = grain == 0 ? 1 : grain;
+			if (m_WorkerCount == 0 || count <= Grain) {
+				function(size_type(0), count);
+				return;
+			}
+
+			using FunctionType = std::remove_reference_t<Function>;
+			TaskGroup Group;
+			Task Root;
+			Root.m_Run = [](const void* callable, const size_type begin, const size_type end) {
+				(*static_cast<FunctionType*>(const_cast<void*>(callable)))(begin, end);
+			};
+			Root.m_Function = std::addressof(function);
+			Root.m_Begin = 0;
+			Root.m_End = count;
+			Root.m_Grain = Grain;
+			Root.m_Group = &Group;
+
+			const size_type Queue = local_queue();
+			run(Queue, Root);
+			while (Group.m_Pending.load(std::memory_order_acquire) > 0) {
+				Task Next;
+				if (find_task(Queue, Next))
+					run(Queue, Next);
+				else
+					std::this_thread::yield();
+			}
+
+			if (Group.m_Error)
+				std::rethrow_exception(Group.m_Error);
+		}
+
+		inline size_type worker_count() const noexcept { return m_WorkerCount; }
+
+	private:
+		inline void run(const size_type queue, Task task) noexcept {
+			TaskGroup& Group = *task.m_Group;
+			if (!Group.m_Failed.load(std::memory_order_relaxed)) {
+				while (task.m_End - task.m_Begin > task.m_Grain) {
+					Task Upper = task;
+					Upper.m_Begin = task.m_Begin + (task.m_End - task.m_Begin) / 2;
+					task.m_End = Upper.m_Begin;
+
+					Group.m_Pending.fetch_add(1, std::memory_order_relaxed);
+					if (!push(queue, Upper)) {
+						//Out of memory for the queue, the range is finished here instead.
+						Group.m_Pending.fetch_sub(1, std::memory_order_relaxed);
+						task.m_End = Upper.m_End;
+						break;
+					}
+				}
+
+				try {
+					task.m_Run(task.m_Function, task.m_Begin, task.m_End);
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> Guard(Group.m_ErrorLock);
+					if (!Group.m_Error)
+						Group.m_Error = std::current_exception();
+					Group.m_Failed.store(true, std::memory_order_relaxed);
+				}
+			}
+
+			//The group lives on the stack of the waiting thread, it must not be touched after this.
+			Group.m_Pending.fetch_sub(1, std::memory_order_acq_rel);
+		}
+
+		inline bool push(const size_type queue, const Task& task) noexcept {
+			try {
+				std::lock_guard<std::mutex> Guard(m_Queues[queue].m_Lock);
+				m_Queues[queue].m_Tasks.push_back(task);
+				m_Queued.fetch_add(1);
+			}
+			catch (...) {
+				return false;
+			}
+
+			if (m_Sleeping.load() > 0) {
+				std::lock_guard<std::mutex> Guard(m_SleepLock);
+				m_Wake.notify_one();
+			}
+			return true;
+		}
+		inline bool find_task(const size_type queue, Task& task) {
+			if (m_Queued.load() == 0)
+				return false;
+
+			{
+				WorkQueue& Own = m_Queues[queue];
+				std::lock_guard<std::mutex> Guard(Own.m_Lock);
+				if (!Own.m_Tasks.empty()) {
+					task = Own.m_Tasks.back();
+					Own.m_Tasks.pop_back();
+					m_Queued.fetch_sub(1);
+					return true;
+				}
+			}
+
+			for (size_type i = 1; i <= m_WorkerCount; i++) {
+				WorkQueue& Victim = m_Queues[(queue + i) % (m_WorkerCount + 1)];
+				std::lock_guard<std::mutex> Guard(Victim.m_Lock);
+				if (!Victim.m_Tasks.empty()) {
+					task = Victim.m_Tasks.front();
+					Victim.m_Tasks.pop_front();
+					m_Queued.fetch_sub(1);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		inline void worker_loop(const size_type index) {
+			WorkerIdentity& Identity = identity();
+			Identity.m_Pool = this;
+			Identity.m_Index = index;
+
+			while (true) {
+				Task Next;
+				if (find_task(index, Next)) {
+					run(index, Next);
+					continue;
+				}
+
+				std::unique_lock<std::mutex> Lock(m_SleepLock);
+				m_Sleeping.fetch_add(1);
+				m_Wake.wait(Lock, [this] { return m_Stopping || m_Queued.load() > 0; });
+				m_Sleeping.fetch_sub(1);
+				if (m_Stopping && m_Queued.load() == 0)
+					return;
+			}
+		}
+
+		inline size_type local_queue() noexcept {
+			//Threads outside the pool share the last queue.
+			const WorkerIdentity& Identity = identity();
+			return Identity.m_Pool == this ? Identity.m_Index : m_WorkerCount;
+		}
+		static inline WorkerIdentity& identity() noexcept {
+			thread_local WorkerIdentity Identity;
+			return Identity;
+		}
+
+	private:
+		std::unique_ptr<WorkQueue[]> m_Queues;
+		std::vector<std::thread> m_Workers;
+		size_type m_WorkerCount = 0;
+
+		std::atomic<size_type> m_Queued{ 0 };
+		std::atomic<size_type> m_Sleeping{ 0 };
+		std::mutex m_SleepLock;
+		std::condition_variable m_Wake;
+		bool m_Stopping = false;
+	};
+
+
+	//Execution policy selecting the parallel overloads of Container and its algorithms.
+	//Both limits are in elements, a null pool means ThreadPool::instance().
+	struct ParallelPolicy {
+		ThreadPool* m_Pool = nullptr;
+		std::size_t m_Threshold = PARALLEL_THRESHOLD;
+		std::size_t m_Grain = PARALLEL_GRAIN;
+
+		inline ThreadPool& pool() const { return m_Pool ? *m_Pool : ThreadPool::instance(); }
+		inline bool is_serial(const std::size_t count) const { return count < m_Threshold || pool().worker_count() == 0; }
+		inline std::size_t chunk_count(const std::size_t count) const noexcept {
+			const std::size_t Grain = m_Grain == 0 ? 1 : m_Grain;
+			return (count + Grain - 1) / Grain;
+		}
+	};
+	inline constexpr ParallelPolicy PARALLEL{};
+}
+
+#endif // !THREAD_POOL_H
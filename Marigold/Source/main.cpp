@@ -1,8 +1,334 @@
 #include "iostream"
 #include "Container.h"
+#include "Profiler.h"
+#include <cstdlib>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Benchmarks Container against std::vector and pmr::Container.
+//Usage: Marigold [--format=table|csv|json] [--filter=<case substring>] [--repetitions=<count>]
+//Every case is timed with plain allocators, then run once more with tracking allocators that count the
+//container's own block allocations and peak bytes. Allocations made inside elements (std::string) are not counted.
+
+namespace {
+	using namespace Marigold;
+	using Profiler::Stopwatch;
+
+	constexpr std::size_t BENCHMARK_SIZES[] = { 16, 1024, 64 * 1024 };
+	constexpr std::size_t MIDDLE_OPERATIONS = 256;
+	constexpr std::size_t MOVE_ROUND_TRIPS = 1024;
+
+	struct Options {
+		Profiler::ReportFormat m_Format = Profiler::ReportFormat::TABLE;
+		std::string_view m_Filter;
+		std::size_t m_Repetitions = 11;
+	};
+
+
+	//Allocation tracking
+	struct VectorTag;
+	struct ContainerTag;
+	struct PmrTag;
+
+	template<class T, class Telemetry>
+	struct TrackingAllocator {
+		using value_type = T;
+
+		TrackingAllocator() noexcept = default;
+		template<class U>
+		TrackingAllocator(const TrackingAllocator<U, Telemetry>&) noexcept {}
+
+		[[nodiscard]] T* allocate(const std::size_t count) {
+			Telemetry::on_allocate(count * sizeof(T));
+			return std::allocator<T>().allocate(count);
+		}
+		void deallocate(T* address, const std::size_t count) noexcept {
+			Telemetry::on_deallocate(count * sizeof(T));
+			std::allocator<T>().deallocate(address, count);
+		}
+
+		friend bool operator==(const TrackingAllocator&, const TrackingAllocator&) noexcept { return true; }
+	};
+
+	template<class Telemetry>
+	class TrackingResource final : public std::pmr::memory_resource {
+	private:
+		void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+			Telemetry::on_allocate(bytes);
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+		void do_deallocate(void* address, const std::size_t bytes, const std::size_t alignment) override {
+			Telemetry::on_deallocate(bytes);
+			std::pmr::new_delete_resource()->deallocate(address, bytes, alignment);
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	};
+
+	//Stands in for the stopwatch in the tracking run, the window between start() and stop() is what gets counted.
+	template<class Telemetry>
+	class AllocationProbe final {
+	public:
+		inline void start() noexcept { Telemetry::reset(); }
+		inline void stop() noexcept { m_Snapshot = Telemetry::snapshot(); }
+
+		inline const TelemetrySnapshot& snapshot() const noexcept { return m_Snapshot; }
+
+	private:
+		TelemetrySnapshot m_Snapshot;
+	};
+
+
+	//Contenders, each names the container timed and the one tracked for allocations.
+	struct VectorContender {
+		static constexpr std::string_view NAME = "std::vector";
+
+		using Telemetry = InstrumentedTelemetry<VectorTag>;
+		template<class T>
+		using Timed = std::vector<T>;
+		template<class T>
+		using Tracked = std::vector<T, TrackingAllocator<T, Telemetry>>;
+
+		static inline void begin_tracking() noexcept {}
+		static inline void end_tracking() noexcept {}
+	};
+
+	struct ContainerContender {
+		static constexpr std::string_view NAME = "Container";
+
+		using Telemetry = InstrumentedTelemetry<ContainerTag>;
+		template<class T>
+		using Timed = Container<T, CustomAllocator<T, 0, NoTelemetry>>;
+		template<class T>
+		using Tracked = Container<T, CustomAllocator<T, 0, Telemetry>>;
+
+		static inline void begin_tracking() noexcept {}
+		static inline void end_tracking() noexcept {}
+	};
+
+	struct PmrContender {
+		static constexpr std::string_view NAME = "pmr::Container";
+
+		using Telemetry = InstrumentedTelemetry<PmrTag>;
+		template<class T>
+		using Timed = Marigold::pmr::Container<T>;
+		template<class T>
+		using Tracked = Marigold::pmr::Container<T>;
+
+		//Copies select the default resource, so tracking swaps the default rather than passing a resource around.
+		static inline void begin_tracking() noexcept { std::pmr::set_default_resource(&resource()); }
+		static inline void end_tracking() noexcept { std::pmr::set_default_resource(nullptr); }
+
+		static inline TrackingResource<Telemetry>& resource() noexcept {
+			static TrackingResource<Telemetry> Resource;
+			return Resource;
+		}
+	};
+
+
+	//Element types
+	template<class T>
+	struct Element;
+
+	template<>
+	struct Element<int> {
+		static constexpr std::string_view NAME = "int";
+
+		static inline int make(const std::size_t index) noexcept { return static_cast<int>(index * 2654435761u); }
+		template<class C>
+		static inline void emplace(C& container, const std::size_t index) { container.emplace_back(static_cast<int>(index)); }
+		static inline std::size_t weight(const int value) noexcept { return static_cast<std::size_t>(value); }
+	};
+
+	template<>
+	struct Element<std::string> {
+		static constexpr std::string_view NAME = "string";
+		static constexpr std::size_t LENGTH = 32; //Past every small string buffer, so each element owns a heap block.
+
+		static inline std::string make(const std::size_t index) { return std::string(LENGTH, static_cast<char>('a' + index % 26)); }
+		template<class C>
+		static inline void emplace(C& container, const std::size_t index) { container.emplace_back(LENGTH, static_cast<char>('a' + index % 26)); }
+		static inline std::size_t weight(const std::string& value) noexcept { return value.size(); }
+	};
+
+
+	template<class Contender, class T>
+	void run_cases(Profiler::Report& report, const Options& options, const std::size_t size) {
+		using Traits = Element<T>;
+		using Telemetry = typename Contender::Telemetry;
+
+		std::vector<T> Source;
+		Source.reserve(size);
+		for (std::size_t i = 0; i < size; i++)
+			Source.push_back(Traits::make(i));
+
+		const auto Record = [&](const std::string_view name, const std::size_t operations, auto body) {
+			if (!options.m_Filter.empty() && name.find(options.m_Filter) == std::string_view::npos)
+				return;
+
+			Profiler::Measurement Result;
+			Result.m_Case = name;
+			Result.m_Element = Traits::NAME;
+			Result.m_Size = size;
+			Result.m_Contender = Contender::NAME;
+			Result.m_NanosecondsPerOperation = Profiler::measure(options.m_Repetitions, operations, [&](Stopwatch& watch) {
+				body.template operator()<typename Contender::template Timed<T>>(watch);
+			});
+
+			Contender::begin_tracking();
+			AllocationProbe<Telemetry> Probe;
+			body.template operator()<typename Contender::template Tracked<T>>(Probe);
+			Contender::end_tracking();
+
+			//The peak restarts from the live bytes at start(), which are recovered from the counters of the window.
+			const TelemetrySnapshot& Snapshot = Probe.snapshot();
+			const std::size_t Baseline = Snapshot.m_LiveMemory + Snapshot.m_DeallocatedMemory - Snapshot.m_AllocatedMemory;
+			Result.m_Allocations = Snapshot.m_Allocations;
+			Result.m_PeakBytes = Snapshot.m_PeakMemory - Baseline;
+			report.add(std::move(Result));
+		};
+
+		const auto Filled = [&]<class Target>() {
+			Target Result;
+			Result.insert(Result.end(), Source.begin(), Source.end());
+			return Result;
+		};
+
+		Record("push_back", size, [&]<class Target>(auto& watch) {
+			Target Subject;
+			watch.start();
+			for (std::size_t i = 0; i < size; i++)
+				Subject.push_back(Source[i]);
+			watch.stop();
+			Profiler::keep(Subject.size());
+		});
+		Record("emplace_back", size, [&]<class Target>(auto& watch) {
+			Target Subject;
+			watch.start();
+			for (std::size_t i = 0; i < size; i++)
+				Traits::emplace(Subject, i);
+			watch.stop();
+			Profiler::keep(Subject.size());
+		});
+		Record("reserve_fill", size, [&]<class Target>(auto& watch) {
+			Target Subject;
+			watch.start();
+			Subject.reserve(size);
+			for (std::size_t i = 0; i < size; i++)
+				Subject.push_back(Source[i]);
+			watch.stop();
+			Profiler::keep(Subject.size());
+		});
+		Record("range_insert", size, [&]<class Target>(auto& watch) {
+			Target Subject;
+			watch.start();
+			Subject.insert(Subject.end(), Source.begin(), Source.end());
+			watch.stop();
+			Profiler::keep(Subject.size());
+		});
+
+		const std::size_t Middle = size < MIDDLE_OPERATIONS ? size : MIDDLE_OPERATIONS;
+		Record("middle_insert", Middle, [&]<class Target>(auto& watch) {
+			Target Subject = Filled.template operator()<Target>();
+			watch.start();
+			for (std::size_t i = 0; i < Middle; i++)
+				Subject.insert(Subject.begin() + Subject.size() / 2, Source[i]);
+			watch.stop();
+			Profiler::keep(Subject.size());
+		});
+		Record("middle_erase", Middle, [&]<class Target>(auto& watch) {
+			Target Subject = Filled.template operator()<Target>();
+			watch.start();
+			for (std::size_t i = 0; i < Middle; i++)
+				Subject.erase(Subject.begin() + Subject.size() / 2);
+			watch.stop();
+			Profiler::keep(Subject.size());
+		});
+		Record("copy", size, [&]<class Target>(auto& watch) {
+			const Target Original = Filled.template operator()<Target>();
+			watch.start();
+			Target Copy(Original);
+			watch.stop();
+			Profiler::keep(Copy.size());
+		});
+		Record("move", MOVE_ROUND_TRIPS * 2, [&]<class Target>(auto& watch) {
+			Target First = Filled.template operator()<Target>();
+			watch.start();
+			for (std::size_t i = 0; i < MOVE_ROUND_TRIPS; i++) {
+				Target Second(std::move(First));
+				First = std::move(Second);
+			}
+			watch.stop();
+			Profiler::keep(First.size());
+		});
+		Record("iterate", size, [&]<class Target>(auto& watch) {
+			const Target Subject = Filled.template operator()<Target>();
+			std::size_t Total = 0;
+			watch.start();
+			for (const T& Value : Subject)
+				Total += Traits::weight(Value);
+			watch.stop();
+			Profiler::keep(Total);
+		});
+		Record("clear", size, [&]<class Target>(auto& watch) {
+			Target Subject = Filled.template operator()<Target>();
+			watch.start();
+			Subject.clear();
+			watch.stop();
+			Profiler::keep(Subject.size());
+		});
+	}
+
+	template<class T>
+	void run_element(Profiler::Report& report, const Options& options) {
+		for (const std::size_t Size : BENCHMARK_SIZES) {
+			//Cases of one size are recorded contender after contender, so the table can put them side by side.
+			Profiler::Report Sized[3];
+			run_cases<VectorContender, T>(Sized[0], options, Size);
+			run_cases<ContainerContender, T>(Sized[1], options, Size);
+			run_cases<PmrContender, T>(Sized[2], options, Size);
+
+			for (std::size_t Case = 0; Case < Sized[0].measurements().size(); Case++) {
+				for (const Profiler::Report& Contender : Sized)
+					report.add(Contender.measurements()[Case]);
+			}
+		}
+	}
+
+	Options parse_options(const int argc, char** argv) {
+		Options Result;
+		for (int i = 1; i < argc; i++) {
+			const std::string_view Argument = argv[i];
+			if (Argument == "--format=csv")
+				Result.m_Format = Profiler::ReportFormat::CSV;
+			else if (Argument == "--format=json")
+				Result.m_Format = Profiler::ReportFormat::JSON;
+			else if (Argument == "--format=table")
+				Result.m_Format = Profiler::ReportFormat::TABLE;
+			else if (Argument.starts_with("--filter="))
+				Result.m_Filter = Argument.substr(9);
+			else if (Argument.starts_with("--repetitions=")) {
+				const long Repetitions = std::strtol(argv[i] + 14, nullptr, 10);
+				Result.m_Repetitions = Repetitions > 0 ? static_cast<std::size_t>(Repetitions) : 1;
+			}
+			else
+				std::cerr << "Ignoring unknown argument " << Argument << '\n';
+		}
+
+		return Result;
+	}
+}
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv) {
+	const Options Settings = parse_options(argc, argv);
 
+	Profiler::Report Report;
+	run_element<int>(Report, Settings);
+	run_element<std::string>(Report, Settings);
+	Report.write(std::cout, Settings.m_Format);
 
 	return 0;
-}
\ No newline at end of file
+}